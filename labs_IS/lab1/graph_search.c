@@ -4,6 +4,11 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Поиски здесь буквально повторяют псевдокод лабораторной (проверка цели при переборе потомков,
+// проверка "не в Open и не в Closed"), и graph_gui.py сравнивает алгоритмы по их STEPS.
+// Поэтому они не переведены на общий движок lab2/search_engine.c: там другие правила
+// счета шагов. Тот же формат графа движок читает сам (graphProblem в lab2/search_problems.c).
+
 #define FIRST_VERTEX 1
 #define END_MARKER   0
 
@@ -1,10 +1,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "dlx.h"
+#include "subtree_kernel.h"
+#include "queens_complete.h"
 
 typedef struct State {
     int *board;              // board[row] = col, если в строке row стоит ферзь; иначе -1
     int row;                 // глубина состояния: сколько ферзей уже поставлено
+    uint32_t cols;           // битовая маска занятых столбцов
+    uint32_t diag;           // диагонали, бьющие следующую строку (сдвиг влево на каждой строке)
+    uint32_t anti;           // антидиагонали, бьющие следующую строку (сдвиг вправо на каждой строке)
     struct State *parent;    // родитель для восстановления пути
 } State;
 
@@ -13,33 +27,421 @@ typedef struct Node {
     struct Node *next;
 } Node;
 
+// Слэб арены: память выдается сдвигом указателя, освобождается только целиком
+typedef struct Slab {
+    struct Slab *next;
+    size_t used;
+    size_t capacity;
+} Slab;
+
+typedef struct {
+    Slab *slabs;
+    size_t slabSize;          // размер полезной части одного слэба, байт
+    size_t reservedBytes;     // сколько байт получено от malloc всеми слэбами
+    int slabCount;            // число вызовов malloc
+} Arena;
+
+// Пул одного запуска solve*: заголовки State, доски и узлы списков живут до releaseSearchPool
+typedef struct {
+    int N;
+    Arena headers;
+    Arena boards;
+    Arena nodes;
+    State *freeStates;        // повторно используемые состояния (связаны через parent)
+    Node *freeNodes;          // повторно используемые узлы списков
+} SearchPool;
+
 typedef struct {
     Node *front;
     Node *back;
     int size;
+    SearchPool *pool;         // откуда берутся и куда возвращаются узлы
 } List;
 
+// Path - стек состояний от корня до текущей вершины; массив выделяется один раз на весь поиск
+typedef struct {
+    State **items;
+    int size;
+    int capacity;
+} Path;
+
+// Ячейка хеш-множества: state == NULL означает пустую ячейку
+typedef struct {
+    uint64_t hash;
+    State *state;
+} StateSlot;
+
+// Хеш-множество состояний с открытой адресацией (линейное пробирование), ключ - (row, board[0..row-1])
+typedef struct {
+    StateSlot *slots;
+    size_t capacity;          // всегда степень двойки
+    size_t size;
+    size_t peakBytes;         // при росте старая и новая таблицы живут одновременно
+    int allocations;
+} StateSet;
+
+// Слой компактного BFS: состояние глубины d - пара (индекс родителя в слое d-1, столбец ферзя в строке d-1)
+typedef struct {
+    uint32_t *parent;
+    uint8_t *col;
+    size_t size;
+    size_t capacity;
+} Layer;
+
+// Значение stepsToFirstSolution, пока решение не найдено
+#define NO_SOLUTION_STEP UINT64_MAX
+
+// Максимальная доска для перебора: маски столбцов и диагоналей - 32-битные
+#define MAX_N 32
+
 typedef struct {
-    int solutionCount;        // сколько целевых состояний найдено
-    int expandedStates;       // счетчик шагов: сколько состояний извлечено/рассмотрено
-    int stepsToFirstSolution; // номер шага, на котором впервые найдено решение; -1, если нет
+    uint64_t solutionCount;        // сколько целевых состояний найдено
+    uint64_t expandedStates;       // счетчик шагов: сколько состояний извлечено/рассмотрено
+    uint64_t stepsToFirstSolution; // номер шага, на котором впервые найдено решение; NO_SOLUTION_STEP, если нет
+    size_t peakBytes;         // пиковый объем памяти арен пула и хеш-множества
+    int allocations;          // число вызовов malloc для слэбов и таблиц хеш-множества
 } SearchStats;
 
+// Задача параллельного подсчета: маски расстановки первых prefixDepth строк
+typedef struct {
+    uint32_t cols;
+    uint32_t diag;
+    uint32_t anti;
+} PrefixTask;
+
+// Решения одной задачи в режиме перечисления: по Q байт-столбцов на решение подряд
+typedef struct {
+    uint8_t *cols;
+    size_t count;
+    size_t capacity;
+    int allocations;
+} SolutionBuffer;
+
+// Очередь задач потока: владелец берет с головы, остальные потоки крадут с хвоста
+typedef struct {
+    pthread_mutex_t lock;
+    size_t head;
+    size_t tail;
+} TaskDeque;
+
+// Итоги потока: поток копирует их в общий массив один раз, при завершении
+typedef struct {
+    uint64_t solutions;
+    uint64_t nodes;
+    uint64_t stolen;
+} WorkerCounters;
+
+// Память параллельного подсчета; выделяет и освобождает ее только главный поток
+typedef struct {
+    size_t liveBytes;
+    size_t peakBytes;
+    int allocations;
+} MemoryUsage;
+
+// Контрольные точки параллельного подсчета
+typedef struct {
+    const char *path;         // NULL - контрольные точки не пишутся
+    bool resume;              // продолжить с сохраненной точки, если файл есть
+    int intervalSeconds;
+} CheckpointConfig;
+
+typedef struct {
+    int N;
+    int Q;
+    int prefixDepth;
+    uint32_t mask;
+    const PrefixTask *tasks;
+    const uint8_t *prefixCols;    // по prefixDepth столбцов на задачу
+    size_t taskCount;
+    const size_t *order;          // очереди хранят позиции в этом списке невыполненных задач
+    int threads;
+    TaskDeque *deques;
+    WorkerCounters *counters;
+    SolutionBuffer *buffers;      // по буферу на задачу; NULL в режиме подсчета
+
+    // Итоги по задачам для контрольных точек: taskDone выставляется после записи счетчиков
+    uint8_t *taskDone;
+    uint64_t *taskSolutions;
+    uint64_t *taskNodes;
+    MemoryUsage memory;           // структуры подсчета без буферов файла контрольной точки
+    pthread_mutex_t finishLock;
+    pthread_cond_t finishCond;
+    int finishedWorkers;
+} ParallelContext;
+
+typedef struct {
+    ParallelContext *ctx;
+    int id;
+} WorkerArg;
+
+typedef struct {
+    uint64_t solutionCount;
+    uint64_t expandedStates;
+    uint64_t stolenTasks;
+    size_t taskCount;
+    size_t resumedTasks;      // задач, выполненных до возобновления
+    int prefixDepth;
+    int threads;
+    int checkpoints;
+    double checkpointSeconds;
+    double seconds;
+    size_t peakBytes;         // задачи, их итоги, очереди потоков и буферы решений
+    int allocations;          // по MemoryUsage контекста
+} ParallelStats;
+
+// Состояние фронта параллельного BFS; доска хранится отдельно, по depth байт на состояние
+typedef struct {
+    uint32_t cols;
+    uint32_t diag;
+    uint32_t anti;
+    uint64_t hash;
+    size_t slot;              // ячейка хеш-множества слоя, найденная при вставке
+} FrontierState;
+
+// Потомки, порожденные одним потоком из своего среза слоя
+typedef struct {
+    FrontierState *states;
+    uint8_t *boards;
+    size_t size;
+    size_t capacity;
+    size_t survivors;         // потомков, оставшихся после удаления дубликатов
+    size_t offset;            // позиция первого из них в следующем слое
+    int allocations;
+} ChildBuffer;
+
+// Общие данные потоков параллельного BFS; фазы слоя разделены барьером
+typedef struct {
+    int N;
+    int threads;
+    int depth;                // глубина текущего слоя
+    const FrontierState *layer;
+    const uint8_t *boards;
+    size_t layerSize;
+    FrontierState *nextLayer;
+    uint8_t *nextBoards;
+    ChildBuffer *children;    // по буферу на поток
+    uint64_t *slots;          // 0 - пусто, иначе (поток << 40 | индекс потомка) + 1
+    size_t slotMask;
+    pthread_barrier_t barrier;
+    bool done;
+} BfsContext;
+
+typedef struct {
+    BfsContext *ctx;
+    int id;
+} BfsWorkerArg;
+
+typedef enum {
+    OUTPUT_FULL = 1,          // операторы и доска для каждого решения
+    OUTPUT_COMPACT = 2,       // одна строка на решение: столбцы ферзей по строкам
+    OUTPUT_COUNT = 3          // только подсчет, доски не строятся и не выводятся
+} OutputMode;
+
+// Буфер вывода решений: текст собирается в памяти и уходит в stdout одним fwrite
+typedef struct {
+    OutputMode mode;
+    char *data;
+    size_t len;
+    size_t capacity;
+} SolutionOutput;
+
+// Перебор с учетом симметрии доски (группа диэдра из 8 преобразований)
+typedef struct {
+    int N;
+    uint32_t mask;
+    int *board;
+    int *image;               // рабочий буфер для образов решения
+    int *best;
+    SolutionOutput *out;      // выводятся только канонические решения
+    size_t peakBytes;         // рабочие массивы board, image и best
+    int allocations;
+    uint64_t printed;
+    uint64_t weight;          // сколько решений полного перебора представляет текущая ветвь
+    uint64_t uniqueCount;     // решений с точностью до поворотов и отражений
+    uint64_t totalCount;      // все решения, восстановленные по симметрии
+    uint64_t expandedStates;
+} SymmetrySearch;
+
+// Локальный поиск min-conflicts: доска - перестановка столбцов, счетчики ферзей на диагоналях
+typedef struct {
+    int N;
+    int *board;
+    int *diag;                // ферзей на диагонали row + col
+    int *anti;                // ферзей на диагонали row - col + N - 1
+    int64_t collisions;       // лишних ферзей на всех диагоналях; 0 - решение
+    uint64_t rng;
+    uint64_t swaps;           // принятых обменов
+    uint64_t evaluations;     // оцененных обменов
+    int restarts;
+    bool solved;
+    double seconds;
+} LocalSearch;
+
+// Счетчик решений подсчета с мемоизацией: при N = 32 число расстановок не помещается в 64 бита
+typedef unsigned __int128 BigCount;
+
+// Запись таблицы мемоизации: сигнатура поддерева и число его решений; column < 0 - пустая запись
+typedef struct {
+    uint32_t rows;
+    uint32_t diag;
+    uint32_t anti;
+    int32_t column;
+    BigCount count;
+} MemoEntry;
+
+// Подсчет с мемоизацией поддеревьев по (column, rows, diag, anti)
+typedef struct {
+    int N;
+    int Q;
+    uint32_t mask;            // Q младших битов: строки полосы
+    MemoEntry *table;
+    size_t capacity;          // степень двойки, фиксируется бюджетом памяти
+    size_t used;
+    BigCount solutionCount;
+    uint64_t visitedStates;   // реально посещенные вершины
+    uint64_t hits;
+    uint64_t replaced;        // записей вытеснено из-за нехватки места
+    double seconds;
+} MemoSearch;
+
 typedef enum {
     METHOD_BFS = 1,
     METHOD_DFS_ITER = 2,
     METHOD_DFS_REC = 3,
     METHOD_DFS_REC_PATH = 4,
-    METHOD_ALL = 5
+    METHOD_ALL = 5,
+    METHOD_BFS_COMPACT = 6,
+    METHOD_PARALLEL = 7,
+    METHOD_SYMMETRY = 8,
+    METHOD_MIN_CONFLICTS = 9,
+    METHOD_MEMO_COUNT = 10,
+    METHOD_DLX = 11,
+    METHOD_DLX_BENCH = 12,
+    METHOD_BFS_PARALLEL = 13,
+    METHOD_KERNEL_BENCH = 14,
+    METHOD_COMPLETE = 15,
+    METHOD_UNKNOWN = 0
 } SearchMethod;
 
+// Параметры одного запуска: заполняются из меню или из командной строки
+typedef struct {
+    int N;
+    int Q;
+    SearchMethod method;
+    int maxDepth;
+    int threads;
+    int memoMegabytes;        // бюджет таблицы мемоизации
+    bool diagonals;           // DLX: ограничения диагоналей (без них - задача о ладьях)
+    bool firstOnly;           // DLX и достроение: остановка на первом решении
+    int board[MAX_N];         // частичная расстановка для достроения; -1 - пустая строка
+    const char *boardSpec;    // --board в исходном виде
+    CheckpointConfig checkpoint;
+    OutputMode output;
+} RunConfig;
+
+// Арены и пул состояний.
+
+#define SLAB_SIZE (64 * 1024)
+#define ARENA_ALIGN 16
+
+static void initArena(Arena *arena, size_t slabSize)
+{
+    arena->slabs = NULL;
+    arena->slabSize = slabSize;
+    arena->reservedBytes = 0;
+    arena->slabCount = 0;
+}
+
+static void *arenaAlloc(Arena *arena, size_t bytes)
+{
+    bytes = (bytes + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    Slab *slab = arena->slabs;
+    if (slab == NULL || slab->capacity - slab->used < bytes) {
+        size_t capacity = (bytes > arena->slabSize) ? bytes : arena->slabSize;
+        size_t header = (sizeof(Slab) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+        slab = (Slab *)malloc(header + capacity);
+        if (!slab) {
+            fprintf(stderr, "Ошибка выделения памяти для арены.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        slab->next = arena->slabs;
+        slab->used = header;
+        slab->capacity = header + capacity;
+        arena->slabs = slab;
+        arena->reservedBytes += header + capacity;
+        arena->slabCount++;
+    }
+
+    void *ptr = (unsigned char *)slab + slab->used;
+    slab->used += bytes;
+    return ptr;
+}
+
+// Освобождение всех слэбов разом
+static void releaseArena(Arena *arena)
+{
+    Slab *slab = arena->slabs;
+    while (slab != NULL) {
+        Slab *next = slab->next;
+        free(slab);
+        slab = next;
+    }
+
+    arena->slabs = NULL;
+}
+
+static void initSearchPool(SearchPool *pool, int N)
+{
+    pool->N = N;
+    initArena(&pool->headers, SLAB_SIZE);
+    initArena(&pool->boards, SLAB_SIZE);
+    initArena(&pool->nodes, SLAB_SIZE);
+    pool->freeStates = NULL;
+    pool->freeNodes = NULL;
+}
+
+// Сохранение статистики памяти и освобождение всех состояний и узлов запуска
+static void releaseSearchPool(SearchPool *pool, SearchStats *stats)
+{
+    // Арены не возвращают память до конца запуска, поэтому итоговый объем и есть пиковый
+    stats->peakBytes = pool->headers.reservedBytes + pool->boards.reservedBytes + pool->nodes.reservedBytes;
+    stats->allocations = pool->headers.slabCount + pool->boards.slabCount + pool->nodes.slabCount;
+
+    releaseArena(&pool->headers);
+    releaseArena(&pool->boards);
+    releaseArena(&pool->nodes);
+    pool->freeStates = NULL;
+    pool->freeNodes = NULL;
+}
+
+static Node *allocNode(SearchPool *pool)
+{
+    Node *nd = pool->freeNodes;
+    if (nd != NULL) {
+        pool->freeNodes = nd->next;
+        return nd;
+    }
+
+    return (Node *)arenaAlloc(&pool->nodes, sizeof(Node));
+}
+
+static void releaseNode(SearchPool *pool, Node *nd)
+{
+    nd->next = pool->freeNodes;
+    pool->freeNodes = nd;
+}
+
 // Работа со списками OPEN, CLOSED и PATH.
 
-static void initList(List *lst)
+static void initList(List *lst, SearchPool *pool)
 {
     lst->front = NULL;
     lst->back = NULL;
     lst->size = 0;
+    lst->pool = pool;
 }
 
 static bool isListEmpty(const List *lst)
@@ -63,18 +465,14 @@ static State *removeFirst(List *lst)
     }
 
     lst->size--;
-    free(tmp);
+    releaseNode(lst->pool, tmp);
     return state;
 }
 
 // Добавление нового элемента в начало списка
 static void addFirst(List *lst, State *state)
 {
-    Node *nd = (Node *)malloc(sizeof(Node));
-    if (!nd) {
-        fprintf(stderr, "Ошибка выделения памяти для элемента списка.\n");
-        exit(EXIT_FAILURE);
-    }
+    Node *nd = allocNode(lst->pool);
 
     nd->state = state;
     nd->next = lst->front;
@@ -90,11 +488,7 @@ static void addFirst(List *lst, State *state)
 // Добавление нового элемента в конец списка
 static void addLast(List *lst, State *state)
 {
-    Node *nd = (Node *)malloc(sizeof(Node));
-    if (!nd) {
-        fprintf(stderr, "Ошибка выделения памяти для элемента списка.\n");
-        exit(EXIT_FAILURE);
-    }
+    Node *nd = allocNode(lst->pool);
 
     nd->state = state;
     nd->next = NULL;
@@ -109,137 +503,222 @@ static void addLast(List *lst, State *state)
     lst->size++;
 }
 
-// Удаление последнего узла без освобождения состояния: нужно для Path при откате рекурсии
-static State *removeLastNodeOnly(List *lst)
+// Глубина пути не превышает числа ферзей, поэтому стек заводится сразу нужного размера
+static void initPath(Path *path, int capacity)
 {
-    if (lst->front == NULL) {
-        return NULL;
+    path->items = (State **)malloc((size_t)capacity * sizeof(State *));
+    if (!path->items) {
+        fprintf(stderr, "Ошибка выделения памяти для Path.\n");
+        exit(EXIT_FAILURE);
     }
 
-    Node *prev = NULL;
-    Node *cur = lst->front;
+    path->size = 0;
+    path->capacity = capacity;
+}
 
-    while (cur->next != NULL) {
-        prev = cur;
-        cur = cur->next;
-    }
+static void freePath(Path *path)
+{
+    free(path->items);
+    path->items = NULL;
+    path->size = 0;
+    path->capacity = 0;
+}
 
-    State *state = cur->state;
+static void pushPath(Path *path, State *s)
+{
+    path->items[path->size++] = s;
+}
 
-    if (prev == NULL) {
-        lst->front = NULL;
-        lst->back = NULL;
-    } else {
-        prev->next = NULL;
-        lst->back = prev;
+// Снятие вершины без освобождения состояния: нужно при откате рекурсии
+static void popPath(Path *path)
+{
+    path->size--;
+}
+
+// Хеш-множество состояний: быстрая проверка принадлежности OPEN/CLOSED.
+
+#define STATE_SET_INITIAL_CAPACITY 1024
+
+static uint64_t hashState(const State *s)
+{
+    // FNV-1a по глубине и префиксу доски
+    uint64_t h = 1469598103934665603ULL;
+
+    h = (h ^ (uint64_t)(uint32_t)s->row) * 1099511628211ULL;
+    for (int i = 0; i < s->row; i++) {
+        h = (h ^ (uint64_t)(uint32_t)s->board[i]) * 1099511628211ULL;
     }
 
-    lst->size--;
-    free(cur);
-    return state;
+    return h ^ (h >> 29);
 }
 
-// Определение наличия состояния в списке
-static bool contains(const List *lst, const State *s)
+static bool equalStates(const State *a, const State *b)
 {
-    for (Node *cur = lst->front; cur != NULL; cur = cur->next) {
-        const State *t = cur->state;
+    if (a->row != b->row) {
+        return false;
+    }
 
-        if (t->row != s->row) {
-            continue;
+    for (int i = 0; i < a->row; i++) {
+        if (a->board[i] != b->board[i]) {
+            return false;
         }
+    }
 
-        bool equal = true;
-        for (int i = 0; i < s->row; i++) {
-            if (t->board[i] != s->board[i]) {
-                equal = false;
-                break;
-            }
+    return true;
+}
+
+static StateSlot *allocSlots(size_t capacity)
+{
+    StateSlot *slots = (StateSlot *)calloc(capacity, sizeof(StateSlot));
+    if (!slots) {
+        fprintf(stderr, "Ошибка выделения памяти для хеш-множества.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return slots;
+}
+
+static void initStateSet(StateSet *set)
+{
+    set->capacity = STATE_SET_INITIAL_CAPACITY;
+    set->size = 0;
+    set->slots = allocSlots(set->capacity);
+    set->peakBytes = set->capacity * sizeof(StateSlot);
+    set->allocations = 1;
+}
+
+// Освобождение множества; его память добавляется к статистике, уже заполненной releaseSearchPool
+static void freeStateSet(StateSet *set, SearchStats *stats)
+{
+    stats->peakBytes += set->peakBytes;
+    stats->allocations += set->allocations;
+
+    free(set->slots);
+    set->slots = NULL;
+    set->capacity = 0;
+    set->size = 0;
+}
+
+// Поиск ячейки с данным состоянием либо первой пустой ячейки в цепочке пробирования
+static StateSlot *findSlot(StateSlot *slots, size_t capacity, const State *s, uint64_t hash)
+{
+    size_t mask = capacity - 1;
+    size_t i = (size_t)hash & mask;
+
+    while (slots[i].state != NULL) {
+        if (slots[i].hash == hash && equalStates(slots[i].state, s)) {
+            break;
         }
+        i = (i + 1) & mask;
+    }
 
-        if (equal) {
-            return true;
+    return &slots[i];
+}
+
+static void growStateSet(StateSet *set)
+{
+    size_t newCapacity = set->capacity * 2;
+    StateSlot *newSlots = allocSlots(newCapacity);
+
+    set->peakBytes = (set->capacity + newCapacity) * sizeof(StateSlot);
+    set->allocations++;
+
+    for (size_t i = 0; i < set->capacity; i++) {
+        if (set->slots[i].state != NULL) {
+            *findSlot(newSlots, newCapacity, set->slots[i].state, set->slots[i].hash) = set->slots[i];
         }
     }
 
-    return false;
+    free(set->slots);
+    set->slots = newSlots;
+    set->capacity = newCapacity;
 }
 
-// Работа с состояниями задачи о ферзях.
+static bool stateSetContains(const StateSet *set, const State *s)
+{
+    return findSlot(set->slots, set->capacity, s, hashState(s))->state != NULL;
+}
 
-static State *createState(int N, int row)
+// Добавление состояния; множество не владеет состоянием, оно остается в OPEN или CLOSED
+static void stateSetInsert(StateSet *set, State *s)
 {
-    State *s = (State *)malloc(sizeof(State));
-    if (!s) {
-        fprintf(stderr, "Ошибка выделения памяти для состояния.\n");
-        exit(EXIT_FAILURE);
+    // Коэффициент заполнения не выше 1/2, чтобы цепочки пробирования оставались короткими
+    if ((set->size + 1) * 2 > set->capacity) {
+        growStateSet(set);
     }
 
-    s->board = (int *)malloc((size_t)N * sizeof(int));
-    if (!s->board) {
-        free(s);
-        fprintf(stderr, "Ошибка выделения памяти для доски.\n");
-        exit(EXIT_FAILURE);
+    uint64_t hash = hashState(s);
+    StateSlot *slot = findSlot(set->slots, set->capacity, s, hash);
+
+    if (slot->state == NULL) {
+        slot->hash = hash;
+        slot->state = s;
+        set->size++;
+    }
+}
+
+// Работа с состояниями задачи о ферзях.
+
+static State *createState(SearchPool *pool, int row)
+{
+    State *s = pool->freeStates;
+
+    if (s != NULL) {
+        pool->freeStates = s->parent;
+    } else {
+        s = (State *)arenaAlloc(&pool->headers, sizeof(State));
+        s->board = (int *)arenaAlloc(&pool->boards, (size_t)pool->N * sizeof(int));
     }
 
     s->row = row;
+    s->cols = 0;
+    s->diag = 0;
+    s->anti = 0;
     s->parent = NULL;
 
-    for (int i = 0; i < N; i++) {
+    for (int i = 0; i < pool->N; i++) {
         s->board[i] = -1;
     }
 
     return s;
 }
 
-static State *cloneState(const State *src, int N)
+static State *cloneState(SearchPool *pool, const State *src)
 {
-    State *dst = createState(N, src->row);
+    State *dst = createState(pool, src->row);
 
-    for (int i = 0; i < N; i++) {
+    for (int i = 0; i < pool->N; i++) {
         dst->board[i] = src->board[i];
     }
 
+    dst->cols = src->cols;
+    dst->diag = src->diag;
+    dst->anti = src->anti;
     dst->parent = src->parent;
     return dst;
 }
 
-static void freeState(State *s)
+// Возврат состояния в пул: доска остается привязанной к заголовку и переиспользуется вместе с ним
+static void freeState(SearchPool *pool, State *s)
 {
     if (!s) {
         return;
     }
 
-    free(s->board);
-    free(s);
-}
-
-// Полная очистка списка вместе с состояниями
-static void freeListWithStates(List *lst)
-{
-    while (!isListEmpty(lst)) {
-        freeState(removeFirst(lst));
-    }
+    s->parent = pool->freeStates;
+    pool->freeStates = s;
 }
 
-// Очистка только узлов списка: состояния принадлежат CLOSED
-static void freeListNodesOnly(List *lst)
+// Маска из N младших битов: столбцы доски
+static uint32_t fullMask(int N)
 {
-    while (!isListEmpty(lst)) {
-        (void)removeFirst(lst);
-    }
+    return (N >= 32) ? UINT32_MAX : ((1u << N) - 1u);
 }
 
-// Проверка допустимости применения оператора: можно ли поставить ферзя в (row, col)
-static bool isSafe(const int *board, int row, int col)
+// Допустимые операторы одним выражением: столбцы следующей строки, не бьющиеся ни одним ферзем
+static uint32_t freeColumns(const State *state, int N)
 {
-    for (int i = 0; i < row; i++) {
-        if (board[i] == col || abs(board[i] - col) == abs(i - row)) {
-            return false;
-        }
-    }
-
-    return true;
+    return ~(state->cols | state->diag | state->anti) & fullMask(N);
 }
 
 // Проверка достижения целевого состояния: поставлено Q ферзей
@@ -249,163 +728,271 @@ static bool isGoal(const State *state, int Q)
 }
 
 // Порождение дочерних вершин путем применения допустимых операторов
-static void createChildren(const State *parent, int N, bool reverseOrder, List *children)
+static void createChildren(SearchPool *pool, const State *parent, int N, bool reverseOrder, List *children)
 {
-    initList(children);
+    initList(children, pool);
 
     if (parent->row >= N) {
         return;
     }
 
-    if (reverseOrder) {
-        for (int col = N - 1; col >= 0; col--) {
-            if (!isSafe(parent->board, parent->row, col)) {
-                continue;
-            }
+    uint32_t mask = fullMask(N);
+    uint32_t freeCols = freeColumns(parent, N);
+
+    // Младший бит (ctz) дает обход столбцов слева направо, старший (clz) - справа налево
+    while (freeCols != 0) {
+        int col = reverseOrder ? 31 - __builtin_clz(freeCols) : __builtin_ctz(freeCols);
+        uint32_t bit = 1u << col;
+        freeCols &= ~bit;
+
+        State *child = cloneState(pool, parent);
+        child->board[parent->row] = col;
+        child->row = parent->row + 1;
+        child->cols = parent->cols | bit;
+        child->diag = ((parent->diag | bit) << 1) & mask;
+        child->anti = (parent->anti | bit) >> 1;
+        child->parent = (State *)parent;
+        addLast(children, child);
+    }
+}
 
-            State *child = cloneState(parent, N);
-            child->board[parent->row] = col;
-            child->row = parent->row + 1;
-            child->parent = (State *)parent;
-            addLast(children, child);
-        }
-    } else {
-        for (int col = 0; col < N; col++) {
-            if (!isSafe(parent->board, parent->row, col)) {
-                continue;
-            }
+// Вывод решений и статистики.
+
+#define OUTPUT_BUFFER_SIZE (1 << 20)
+
+static void initOutput(SolutionOutput *out, OutputMode mode)
+{
+    out->mode = mode;
+    out->len = 0;
+    out->capacity = OUTPUT_BUFFER_SIZE;
+    out->data = (char *)malloc(out->capacity);
+    if (!out->data) {
+        fprintf(stderr, "Ошибка выделения памяти для буфера вывода.\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+// Сброс накопленного текста; вызывается перед любым printf, чтобы не нарушить порядок вывода
+static void flushOutput(SolutionOutput *out)
+{
+    if (out->len > 0) {
+        fwrite(out->data, 1, out->len, stdout);
+        out->len = 0;
+    }
+}
+
+static void freeOutput(SolutionOutput *out)
+{
+    flushOutput(out);
+    free(out->data);
+    out->data = NULL;
+}
+
+// Гарантия свободного места под запись длины bytes
+static void reserveOutput(SolutionOutput *out, size_t bytes)
+{
+    if (out->capacity - out->len < bytes) {
+        flushOutput(out);
+    }
+}
 
-            State *child = cloneState(parent, N);
-            child->board[parent->row] = col;
-            child->row = parent->row + 1;
-            child->parent = (State *)parent;
-            addLast(children, child);
+static void outText(SolutionOutput *out, const char *text)
+{
+    for (; *text != '\0'; text++) {
+        if (out->len == out->capacity) {
+            flushOutput(out);
         }
+        out->data[out->len++] = *text;
     }
 }
 
-// Вывод решений и статистики.
+// Десятичное число, выровненное вправо по ширине width (как printf("%*d"))
+static void outInt(SolutionOutput *out, long long value, int width)
+{
+    char digits[24];
+    int n = 0;
+    bool negative = value < 0;
+    unsigned long long v = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v != 0);
+
+    if (negative) {
+        digits[n++] = '-';
+    }
+
+    reserveOutput(out, (size_t)(n > width ? n : width));
+    for (int i = n; i < width; i++) {
+        out->data[out->len++] = ' ';
+    }
+    while (n > 0) {
+        out->data[out->len++] = digits[--n];
+    }
+}
 
-static void printBoard(const int *board, int N)
+static void outBoard(SolutionOutput *out, const int *board, int N)
 {
-    printf("   ");
+    outText(out, "   ");
     for (int c = 0; c < N; c++) {
-        printf("%2d ", c + 1);
+        outInt(out, c + 1, 2);
+        outText(out, " ");
     }
-    printf("\n");
+    outText(out, "\n");
 
     for (int r = 0; r < N; r++) {
-        printf("%2d ", r + 1);
+        outInt(out, r + 1, 2);
+        outText(out, " ");
         for (int c = 0; c < N; c++) {
-            printf(board[r] == c ? " Q " : " . ");
+            outText(out, board[r] == c ? " Q " : " . ");
         }
-        printf("\n");
+        outText(out, "\n");
     }
 }
 
-// Восстановление пути через parent: используется BFS, итерационным DFS и обычным рекурсивным DFS
-static void printSolutionByParent(const State *goal, int N, int *solutionCount)
+static void outStep(SolutionOutput *out, int step, int row, int col)
 {
-    (*solutionCount)++;
-    printf("=== Решение %d ===\n", *solutionCount);
+    outText(out, "  Шаг ");
+    outInt(out, step, 0);
+    outText(out, ": строка ");
+    outInt(out, row, 0);
+    outText(out, " -> столбец ");
+    outInt(out, col, 0);
+    outText(out, "\n");
+}
 
-    int depth = 0;
-    for (const State *cur = goal; cur != NULL; cur = cur->parent) {
-        depth++;
+// Компактная строка решения: номер и столбцы ферзей (с 1) по строкам
+static void outCompactLine(SolutionOutput *out, const int *board, int depth, uint64_t solutionCount)
+{
+    outInt(out, (long long)solutionCount, 0);
+    outText(out, ":");
+    for (int i = 0; i < depth; i++) {
+        outText(out, " ");
+        outInt(out, board[i] + 1, 0);
     }
+    outText(out, "\n");
+}
 
-    const State **path = (const State **)malloc((size_t)depth * sizeof(State *));
-    if (!path) {
-        fprintf(stderr, "Ошибка выделения памяти для восстановления пути.\n");
-        exit(EXIT_FAILURE);
+// Вывод решения по доске: board[0..depth-1] - столбцы ферзей в порядке постановки
+static void printSolutionByBoard(SolutionOutput *out, const int *board, int depth, int N, uint64_t *solutionCount)
+{
+    (*solutionCount)++;
+
+    if (out->mode == OUTPUT_COUNT) {
+        return;
     }
 
-    int index = 0;
-    for (const State *cur = goal; cur != NULL; cur = cur->parent) {
-        path[index++] = cur;
+    if (out->mode == OUTPUT_COMPACT) {
+        outCompactLine(out, board, depth, *solutionCount);
+        return;
     }
 
-    printf("Последовательность операторов (строка -> столбец):\n");
-    for (int i = depth - 1; i > 0; i--) {
-        int rowPlaced = path[i]->row;
-        int colPlaced = path[i - 1]->board[rowPlaced];
-        printf("  Шаг %d: строка %d -> столбец %d\n", depth - i, rowPlaced + 1, colPlaced + 1);
+    outText(out, "=== Решение ");
+    outInt(out, (long long)*solutionCount, 0);
+    outText(out, " ===\n");
+
+    outText(out, "Последовательность операторов (строка -> столбец):\n");
+    for (int i = 0; i < depth; i++) {
+        outStep(out, i + 1, i + 1, board[i] + 1);
     }
 
-    printf("Доска:\n");
-    printBoard(goal->board, N);
-    printf("\n");
+    outText(out, "Доска:\n");
+    outBoard(out, board, N);
+    outText(out, "\n");
+}
 
-    free(path);
+// Восстановление пути через parent: используется BFS, итерационным DFS и обычным рекурсивным DFS.
+// Потомок копирует доску родителя, поэтому оператор шага i - это goal->board[i], обход цепочки не нужен.
+static void printSolutionByParent(SolutionOutput *out, const State *goal, int N, uint64_t *solutionCount)
+{
+    printSolutionByBoard(out, goal->board, goal->row, N, solutionCount);
 }
 
 // Непосредственный вывод пути Path
-static void printSolutionByPath(const List *path, int N, int *solutionCount)
+static void printSolutionByPath(SolutionOutput *out, const Path *path, int N, uint64_t *solutionCount)
 {
     (*solutionCount)++;
-    printf("=== Решение %d ===\n", *solutionCount);
-    printf("Последовательность операторов Path (строка -> столбец):\n");
 
-    Node *prev = path->front;
-    Node *cur = (prev != NULL) ? prev->next : NULL;
-    int step = 1;
+    if (out->mode == OUTPUT_COUNT) {
+        return;
+    }
+
+    const State *last = (path->size > 0) ? path->items[path->size - 1] : NULL;
+
+    if (out->mode == OUTPUT_COMPACT) {
+        if (last != NULL) {
+            outCompactLine(out, last->board, last->row, *solutionCount);
+        }
+        return;
+    }
 
-    while (prev != NULL && cur != NULL) {
-        int rowPlaced = prev->state->row;
-        int colPlaced = cur->state->board[rowPlaced];
-        printf("  Шаг %d: строка %d -> столбец %d\n", step, rowPlaced + 1, colPlaced + 1);
+    outText(out, "=== Решение ");
+    outInt(out, (long long)*solutionCount, 0);
+    outText(out, " ===\n");
+    outText(out, "Последовательность операторов Path (строка -> столбец):\n");
 
-        prev = cur;
-        cur = cur->next;
-        step++;
+    for (int i = 1; i < path->size; i++) {
+        int rowPlaced = path->items[i - 1]->row;
+        int colPlaced = path->items[i]->board[rowPlaced];
+        outStep(out, i, rowPlaced + 1, colPlaced + 1);
     }
 
-    printf("Доска:\n");
-    if (path->back != NULL) {
-        printBoard(path->back->state->board, N);
+    outText(out, "Доска:\n");
+    if (last != NULL) {
+        outBoard(out, last->board, N);
     }
-    printf("\n");
+    outText(out, "\n");
 }
 
 static void initStats(SearchStats *stats)
 {
     stats->solutionCount = 0;
     stats->expandedStates = 0;
-    stats->stepsToFirstSolution = -1;
+    stats->stepsToFirstSolution = NO_SOLUTION_STEP;
+    stats->peakBytes = 0;
+    stats->allocations = 0;
 }
 
 static void registerSolutionStep(SearchStats *stats)
 {
-    if (stats->stepsToFirstSolution == -1) {
+    if (stats->stepsToFirstSolution == NO_SOLUTION_STEP) {
         stats->stepsToFirstSolution = stats->expandedStates;
     }
 }
 
 static void printStats(const char *methodName, const SearchStats *stats)
 {
-    printf("%s: всего решений = %d | раскрыто состояний = %d | шагов до первого решения = ", methodName, stats->solutionCount, stats->expandedStates);
+    printf("%s: всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | шагов до первого решения = ", methodName, stats->solutionCount, stats->expandedStates);
 
-    if (stats->stepsToFirstSolution == -1) {
-        printf("не найдено\n\n");
+    if (stats->stepsToFirstSolution == NO_SOLUTION_STEP) {
+        printf("не найдено\n");
     } else {
-        printf("%d\n\n", stats->stepsToFirstSolution);
+        printf("%" PRIu64 "\n", stats->stepsToFirstSolution);
     }
+
+    printf("%s: память пула и хеш-множества = %zu КБ | выделений памяти = %d\n\n", methodName, (stats->peakBytes + 1023) / 1024, stats->allocations);
 }
 
-static SearchStats solveBFS(int N, int Q)
+static SearchStats solveBFS(int N, int Q, SolutionOutput *out)
 {
+    SearchPool pool;
     List openList;
     List closedList;
+    StateSet seen;            // объединение Open и Closed: вершина из Open переходит только в Closed
     SearchStats stats;
 
-    initList(&openList);
-    initList(&closedList);
+    initSearchPool(&pool, N);
+    initList(&openList, &pool);
+    initList(&closedList, &pool);
+    initStateSet(&seen);
     initStats(&stats);
 
-    State *start = createState(N, 0);
+    State *start = createState(&pool, 0);
 
     // Open = [Start]
     addLast(&openList, start);
+    stateSetInsert(&seen, start);
 
     // Closed = []
 
@@ -421,106 +1008,324 @@ static SearchStats solveBFS(int N, int Q)
         // If X = цель then решение найдено
         if (isGoal(X, Q)) {
             registerSolutionStep(&stats);
-            printSolutionByParent(X, N, &stats.solutionCount);
+            printSolutionByParent(out, X, N, &stats.solutionCount);
             continue;
         }
 
         List children;
-        createChildren(X, N, false, &children);
+        createChildren(&pool, X, N, false, &children);
 
         // Для каждого потомка X
         while (!isListEmpty(&children)) {
             State *child = removeFirst(&children);
 
             // If он не в списке Open или Closed then добавить в конец списка Open
-            if (!contains(&openList, child) && !contains(&closedList, child)) {
+            if (!stateSetContains(&seen, child)) {
                 addLast(&openList, child);
+                stateSetInsert(&seen, child);
             } else {
-                freeState(child);
+                freeState(&pool, child);
             }
         }
     }
 
-    freeListWithStates(&openList);
-    freeListWithStates(&closedList);
+    releaseSearchPool(&pool, &stats);
+    freeStateSet(&seen, &stats);
+    flushOutput(out);
     return stats;
 }
 
-static SearchStats solveDFSIterative(int N, int Q, int maxDepth)
+// Компактный BFS: слои массивов (родитель, столбец) вместо State с полной доской.
+
+static void initLayer(Layer *layer)
 {
-    List openList;
-    List closedList;
-    SearchStats stats;
+    layer->parent = NULL;
+    layer->col = NULL;
+    layer->size = 0;
+    layer->capacity = 0;
+}
 
-    initList(&openList);
-    initList(&closedList);
-    initStats(&stats);
+static void freeLayer(Layer *layer)
+{
+    free(layer->parent);
+    free(layer->col);
+    initLayer(layer);
+}
 
-    State *start = createState(N, 0);
+static size_t layerBytes(const Layer *layer)
+{
+    return layer->capacity * (sizeof(uint32_t) + sizeof(uint8_t));
+}
 
-    // Open = [Start]
-    addFirst(&openList, start);
+static void resizeLayer(Layer *layer, size_t capacity, int *allocations)
+{
+    uint32_t *parent = (uint32_t *)realloc(layer->parent, (capacity ? capacity : 1) * sizeof(uint32_t));
+    uint8_t *col = (uint8_t *)realloc(layer->col, (capacity ? capacity : 1) * sizeof(uint8_t));
 
-    // Closed = []
+    if (!parent || !col) {
+        fprintf(stderr, "Ошибка выделения памяти для слоя BFS.\n");
+        exit(EXIT_FAILURE);
+    }
 
-    // While Open <> []
-    while (!isListEmpty(&openList)) {
-        // X = первая вершина из Open; удалить X из Open
-        State *X = removeFirst(&openList);
+    layer->parent = parent;
+    layer->col = col;
+    layer->capacity = capacity;
+    *allocations += 2;
+}
 
-        // Добавить X в Closed
-        addLast(&closedList, X);
-        stats.expandedStates++;
+static void pushLayer(Layer *layer, uint32_t parent, int col, int *allocations)
+{
+    if (layer->size == layer->capacity) {
+        resizeLayer(layer, layer->capacity ? layer->capacity * 2 : 64, allocations);
+    }
 
-        // If X = цель then решение найдено
-        if (isGoal(X, Q)) {
-            registerSolutionStep(&stats);
-            printSolutionByParent(X, N, &stats.solutionCount);
-            continue;
-        }
+    layer->parent[layer->size] = parent;
+    layer->col[layer->size] = (uint8_t)col;
+    layer->size++;
+}
 
-        // Ограниченный перебор в глубину: ниже maxDepth не идем
+// Восстановление доски состояния idx слоя depth по цепочке родителей; возвращает маски для порождения потомков
+static void reconstructBoard(const Layer *layers, int depth, size_t idx, int N, int *board, State *masks)
+{
+    for (int r = N - 1; r >= depth; r--) {
+        board[r] = -1;
+    }
+
+    for (int d = depth; d > 0; d--) {
+        board[d - 1] = layers[d].col[idx];
+        idx = layers[d].parent[idx];
+    }
+
+    uint32_t mask = fullMask(N);
+    masks->row = depth;
+    masks->cols = 0;
+    masks->diag = 0;
+    masks->anti = 0;
+
+    for (int r = 0; r < depth; r++) {
+        uint32_t bit = 1u << board[r];
+        masks->cols |= bit;
+        masks->diag = ((masks->diag | bit) << 1) & mask;
+        masks->anti = (masks->anti | bit) >> 1;
+    }
+}
+
+// Удаление из слоя depth состояний без потомков в слое depth+1 с перенумерацией ссылок.
+// Освободившиеся предки каскадно удаляются из более ранних слоев.
+static void compactLayers(Layer *layers, int depth, int *allocations)
+{
+    for (int d = depth; d > 0; d--) {
+        Layer *layer = &layers[d];
+        Layer *next = &layers[d + 1];
+
+        uint32_t *remap = (uint32_t *)malloc((layer->size ? layer->size : 1) * sizeof(uint32_t));
+        if (!remap) {
+            fprintf(stderr, "Ошибка выделения памяти для сжатия слоя BFS.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        for (size_t i = 0; i < layer->size; i++) {
+            remap[i] = UINT32_MAX;
+        }
+        for (size_t i = 0; i < next->size; i++) {
+            remap[next->parent[i]] = 0;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < layer->size; i++) {
+            if (remap[i] == UINT32_MAX) {
+                continue;
+            }
+
+            remap[i] = (uint32_t)kept;
+            layer->parent[kept] = layer->parent[i];
+            layer->col[kept] = layer->col[i];
+            kept++;
+        }
+
+        for (size_t i = 0; i < next->size; i++) {
+            next->parent[i] = remap[next->parent[i]];
+        }
+
+        free(remap);
+
+        if (kept == layer->size) {
+            return;
+        }
+
+        layer->size = kept;
+        resizeLayer(layer, kept, allocations);
+    }
+}
+
+static size_t totalLayerBytes(const Layer *layers, int count)
+{
+    size_t bytes = 0;
+
+    for (int d = 0; d < count; d++) {
+        bytes += layerBytes(&layers[d]);
+    }
+
+    return bytes;
+}
+
+// Тот же порядок раскрытия, что и в solveBFS: слой за слоем, потомки по возрастанию столбца.
+// Дубликатов в дереве расстановок не бывает, поэтому OPEN и CLOSED как списки не нужны.
+static SearchStats solveBFSCompact(int N, int Q, SolutionOutput *out)
+{
+    SearchStats stats;
+    initStats(&stats);
+
+    // calloc дает пустые слои: нулевые указатели и размеры
+    Layer *layers = (Layer *)calloc((size_t)Q + 1, sizeof(Layer));
+    int *board = (int *)malloc((size_t)N * sizeof(int));
+    if (!layers || !board) {
+        fprintf(stderr, "Ошибка выделения памяти для компактного BFS.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Open = [Start]: корень - единственное состояние слоя 0
+    pushLayer(&layers[0], 0, 0, &stats.allocations);
+
+    for (int d = 0; d <= Q && layers[d].size > 0; d++) {
+        Layer *layer = &layers[d];
+
+        // В режиме подсчета целевой слой не разворачивается в доски: достаточно его размера
+        if (d == Q && out->mode == OUTPUT_COUNT) {
+            stats.expandedStates++;
+            registerSolutionStep(&stats);
+            stats.expandedStates += layer->size - 1;
+            stats.solutionCount += layer->size;
+            break;
+        }
+
+        for (size_t i = 0; i < layer->size; i++) {
+            stats.expandedStates++;
+
+            State masks;
+            reconstructBoard(layers, d, i, N, board, &masks);
+
+            // If X = цель then решение найдено
+            if (isGoal(&masks, Q)) {
+                registerSolutionStep(&stats);
+                printSolutionByBoard(out, board, d, N, &stats.solutionCount);
+                continue;
+            }
+
+            uint32_t freeCols = freeColumns(&masks, N);
+            while (freeCols != 0) {
+                int col = __builtin_ctz(freeCols);
+                freeCols &= freeCols - 1;
+                pushLayer(&layers[d + 1], (uint32_t)i, col, &stats.allocations);
+            }
+        }
+
+        size_t bytes = totalLayerBytes(layers, Q + 1);
+        if (bytes > stats.peakBytes) {
+            stats.peakBytes = bytes;
+        }
+
+        // Состояния слоя d без потомков больше не понадобятся для восстановления досок
+        if (d < Q) {
+            compactLayers(layers, d, &stats.allocations);
+        }
+    }
+
+    for (int d = 0; d <= Q; d++) {
+        freeLayer(&layers[d]);
+    }
+
+    free(layers);
+    free(board);
+    flushOutput(out);
+    return stats;
+}
+
+static SearchStats solveDFSIterative(int N, int Q, int maxDepth, SolutionOutput *out)
+{
+    SearchPool pool;
+    List openList;
+    List closedList;
+    StateSet seen;            // объединение Open и Closed
+    SearchStats stats;
+
+    initSearchPool(&pool, N);
+    initList(&openList, &pool);
+    initList(&closedList, &pool);
+    initStateSet(&seen);
+    initStats(&stats);
+
+    State *start = createState(&pool, 0);
+
+    // Open = [Start]
+    addFirst(&openList, start);
+    stateSetInsert(&seen, start);
+
+    // Closed = []
+
+    // While Open <> []
+    while (!isListEmpty(&openList)) {
+        // X = первая вершина из Open; удалить X из Open
+        State *X = removeFirst(&openList);
+
+        // Добавить X в Closed
+        addLast(&closedList, X);
+        stats.expandedStates++;
+
+        // If X = цель then решение найдено
+        if (isGoal(X, Q)) {
+            registerSolutionStep(&stats);
+            printSolutionByParent(out, X, N, &stats.solutionCount);
+            continue;
+        }
+
+        // Ограниченный перебор в глубину: ниже maxDepth не идем
         if (X->row >= maxDepth) {
             continue;
         }
 
         List children;
         // reverseOrder нужен, чтобы при добавлении в начало OPEN столбцы просматривались слева направо
-        createChildren(X, N, true, &children);
+        createChildren(&pool, X, N, true, &children);
 
         // Для каждого потомка X
         while (!isListEmpty(&children)) {
             State *child = removeFirst(&children);
 
             if (child->row > maxDepth) {
-                freeState(child);
+                freeState(&pool, child);
                 continue;
             }
 
             // If он не в списке Open или Closed then добавить в начало списка Open
-            if (!contains(&openList, child) && !contains(&closedList, child)) {
+            if (!stateSetContains(&seen, child)) {
                 addFirst(&openList, child);
+                stateSetInsert(&seen, child);
             } else {
-                freeState(child);
+                freeState(&pool, child);
             }
         }
     }
 
-    freeListWithStates(&openList);
-    freeListWithStates(&closedList);
+    releaseSearchPool(&pool, &stats);
+    freeStateSet(&seen, &stats);
+    flushOutput(out);
     return stats;
 }
 
-static void dfsRecursiveImpl(State *X, int N, int Q, int maxDepth, List *closedList, SearchStats *stats)
+static void dfsRecursiveImpl(State *X, int N, int Q, int maxDepth, List *closedList, StateSet *closedSet, SearchStats *stats, SolutionOutput *out)
 {
+    SearchPool *pool = closedList->pool;
+
     // Добавить вершину X в список Closed
     addLast(closedList, X);
+    stateSetInsert(closedSet, X);
     stats->expandedStates++;
 
     // If X = цель then распечатать путь
     if (isGoal(X, Q)) {
         registerSolutionStep(stats);
-        printSolutionByParent(X, N, &stats->solutionCount);
+        printSolutionByParent(out, X, N, &stats->solutionCount);
         return;
     }
 
@@ -530,234 +1335,3159 @@ static void dfsRecursiveImpl(State *X, int N, int Q, int maxDepth, List *closedL
     }
 
     List children;
-    createChildren(X, N, false, &children);
+    createChildren(pool, X, N, false, &children);
 
     // Для каждого child
     while (!isListEmpty(&children)) {
         State *child = removeFirst(&children);
 
         if (child->row > maxDepth) {
-            freeState(child);
+            freeState(pool, child);
             continue;
         }
 
         // Else If child не в списке Closed then DepthSearch(child)
-        if (!contains(closedList, child)) {
-            dfsRecursiveImpl(child, N, Q, maxDepth, closedList, stats);
+        if (!stateSetContains(closedSet, child)) {
+            dfsRecursiveImpl(child, N, Q, maxDepth, closedList, closedSet, stats, out);
         } else {
-            freeState(child);
+            freeState(pool, child);
         }
     }
 }
 
-static SearchStats solveDFSRecursive(int N, int Q, int maxDepth)
+static SearchStats solveDFSRecursive(int N, int Q, int maxDepth, SolutionOutput *out)
 {
+    SearchPool pool;
     List closedList;
+    StateSet closedSet;
     SearchStats stats;
 
-    initList(&closedList);
+    initSearchPool(&pool, N);
+    initList(&closedList, &pool);
+    initStateSet(&closedSet);
     initStats(&stats);
 
-    State *start = createState(N, 0);
-    dfsRecursiveImpl(start, N, Q, maxDepth, &closedList, &stats);
+    State *start = createState(&pool, 0);
+    dfsRecursiveImpl(start, N, Q, maxDepth, &closedList, &closedSet, &stats, out);
 
-    freeListWithStates(&closedList);
+    releaseSearchPool(&pool, &stats);
+    freeStateSet(&closedSet, &stats);
+    flushOutput(out);
     return stats;
 }
 
-static void dfsRecursivePathImpl(State *X, int N, int Q, int maxDepth, List *closedList, List *path, SearchStats *stats)
+static void dfsRecursivePathImpl(State *X, int N, int Q, int maxDepth, List *closedList, StateSet *closedSet, Path *path, SearchStats *stats, SolutionOutput *out)
 {
+    SearchPool *pool = closedList->pool;
+
     // Добавить вершину X в список Closed
     addLast(closedList, X);
+    stateSetInsert(closedSet, X);
     stats->expandedStates++;
 
     // Path = Path + X
-    addLast(path, X);
+    pushPath(path, X);
 
     // If X = цель then распечатать Path
     if (isGoal(X, Q)) {
         registerSolutionStep(stats);
-        printSolutionByPath(path, N, &stats->solutionCount);
-        removeLastNodeOnly(path);
+        printSolutionByPath(out, path, N, &stats->solutionCount);
+        popPath(path);
         return;
     }
 
     // Ограничение глубины просмотра
     if (X->row < maxDepth) {
         List children;
-        createChildren(X, N, false, &children);
+        createChildren(pool, X, N, false, &children);
 
         // Для каждого child
         while (!isListEmpty(&children)) {
             State *child = removeFirst(&children);
 
             if (child->row > maxDepth) {
-                freeState(child);
+                freeState(pool, child);
                 continue;
             }
 
             // Else If child не в списке Closed then DepthSearch(child, Path + child)
-            if (!contains(closedList, child)) {
-                dfsRecursivePathImpl(child, N, Q, maxDepth, closedList, path, stats);
+            if (!stateSetContains(closedSet, child)) {
+                dfsRecursivePathImpl(child, N, Q, maxDepth, closedList, closedSet, path, stats, out);
             } else {
-                freeState(child);
+                freeState(pool, child);
             }
         }
     }
 
     // Откат Path при возврате из рекурсии
-    removeLastNodeOnly(path);
+    popPath(path);
 }
 
-static SearchStats solveDFSRecursiveWithPath(int N, int Q, int maxDepth)
+static SearchStats solveDFSRecursiveWithPath(int N, int Q, int maxDepth, SolutionOutput *out)
 {
+    SearchPool pool;
     List closedList;
-    List path;
+    StateSet closedSet;
+    Path path;
     SearchStats stats;
 
-    initList(&closedList);
-    initList(&path);
+    initSearchPool(&pool, N);
+    initList(&closedList, &pool);
+    initStateSet(&closedSet);
+    initPath(&path, maxDepth + 1);
     initStats(&stats);
 
-    State *start = createState(N, 0);
-    dfsRecursivePathImpl(start, N, Q, maxDepth, &closedList, &path, &stats);
+    State *start = createState(&pool, 0);
+    dfsRecursivePathImpl(start, N, Q, maxDepth, &closedList, &closedSet, &path, &stats, out);
 
-    freeListNodesOnly(&path);
-    freeListWithStates(&closedList);
+    releaseSearchPool(&pool, &stats);
+    freeStateSet(&closedSet, &stats);
+    freePath(&path);
+    flushOutput(out);
     return stats;
 }
 
-// Пользовательский ввод и сравнение.
+// Параллельный подсчет: префиксы первых строк раздаются потокам, поддеревья считает битовый DFS.
 
-static int readInt(const char *prompt, int lo, int hi)
+// Задач на поток: с запасом, чтобы кража выравнивала неравные поддеревья
+#define TASKS_PER_THREAD 64
+
+static double nowSeconds(void)
 {
-    int v;
-    int rc;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
 
-    while (1) {
-        printf("%s", prompt);
-        rc = scanf("%d", &v);
+static void *allocOrDie(size_t bytes)
+{
+    void *ptr = malloc(bytes ? bytes : 1);
+    if (!ptr) {
+        fprintf(stderr, "Ошибка выделения памяти для параллельного поиска.\n");
+        exit(EXIT_FAILURE);
+    }
 
-        if (rc == 1 && v >= lo && v <= hi) {
-            return v;
+    return ptr;
+}
+
+static void trackBytes(MemoryUsage *mem, size_t bytes)
+{
+    mem->liveBytes += bytes;
+    if (mem->liveBytes > mem->peakBytes) {
+        mem->peakBytes = mem->liveBytes;
+    }
+}
+
+static void trackAllocation(MemoryUsage *mem, size_t bytes)
+{
+    trackBytes(mem, bytes);
+    mem->allocations++;
+}
+
+static void trackFree(MemoryUsage *mem, size_t bytes)
+{
+    mem->liveBytes -= bytes;
+}
+
+static void appendSolution(SolutionBuffer *buf, const uint8_t *board, int Q)
+{
+    if (buf->count == buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 16;
+        uint8_t *cols = (uint8_t *)realloc(buf->cols, capacity * (size_t)Q);
+        if (!cols) {
+            fprintf(stderr, "Ошибка выделения памяти для буфера решений.\n");
+            exit(EXIT_FAILURE);
         }
 
-        printf("Ошибка: введите число от %d до %d.\n", lo, hi);
+        buf->cols = cols;
+        buf->capacity = capacity;
+        buf->allocations++;
+    }
 
-        while (getchar() != '\n') {
+    for (int r = 0; r < Q; r++) {
+        buf->cols[buf->count * (size_t)Q + (size_t)r] = board[r];
+    }
+    buf->count++;
+}
+
+// Битовый DFS по поддереву: узлы считаются так же, как раскрытые состояния в solveDFSRecursive
+static void countSubtree(const ParallelContext *ctx, int row, uint32_t cols, uint32_t diag, uint32_t anti, uint8_t *board, WorkerCounters *counters, SolutionBuffer *out)
+{
+    counters->nodes++;
+
+    if (row == ctx->Q) {
+        counters->solutions++;
+        if (out != NULL) {
+            appendSolution(out, board, ctx->Q);
         }
+        return;
+    }
+
+    uint32_t freeCols = ~(cols | diag | anti) & ctx->mask;
+    while (freeCols != 0) {
+        uint32_t bit = freeCols & (0u - freeCols);
+        freeCols ^= bit;
+
+        board[row] = (uint8_t)__builtin_ctz(bit);
+        countSubtree(ctx, row + 1, cols | bit, ((diag | bit) << 1) & ctx->mask, (anti | bit) >> 1, board, counters, out);
     }
 }
 
-static const char *bestBySteps(const SearchStats *bfsStats, const SearchStats *dfsIterStats, const SearchStats *dfsRecStats, const SearchStats *dfsPathStats)
+static bool popOwnTask(TaskDeque *dq, size_t *task)
 {
-    const char *bestName = NULL;
-    int bestSteps = 0;
+    bool found = false;
 
-    const char *names[4] = {"BFS", "DFS итерационный", "DFS рекурсивный", "DFS рекурсивный с Path"};
-    const SearchStats *stats[4] = {bfsStats, dfsIterStats, dfsRecStats, dfsPathStats};
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail) {
+        *task = dq->head++;
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
 
-    for (int i = 0; i < 4; i++) {
-        if (stats[i] == NULL || stats[i]->stepsToFirstSolution == -1) {
-            continue;
+    return found;
+}
+
+static bool stealTask(TaskDeque *dq, size_t *task)
+{
+    bool found = false;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->head < dq->tail) {
+        *task = --dq->tail;
+        found = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return found;
+}
+
+static void *parallelWorker(void *arg)
+{
+    WorkerArg *wa = (WorkerArg *)arg;
+    ParallelContext *ctx = wa->ctx;
+    WorkerCounters local = {0};
+    uint8_t board[32];
+
+    while (1) {
+        size_t task;
+        bool found = popOwnTask(&ctx->deques[wa->id], &task);
+
+        // Своя очередь пуста: обходим остальные потоки и крадем задачу с хвоста
+        for (int k = 1; !found && k < ctx->threads; k++) {
+            if (stealTask(&ctx->deques[(wa->id + k) % ctx->threads], &task)) {
+                found = true;
+                local.stolen++;
+            }
         }
 
-        if (bestName == NULL || stats[i]->stepsToFirstSolution < bestSteps) {
-            bestName = names[i];
-            bestSteps = stats[i]->stepsToFirstSolution;
+        // Новые задачи не появляются, поэтому пустые очереди означают конец работы
+        if (!found) {
+            break;
+        }
+
+        task = ctx->order[task];
+        const PrefixTask *t = &ctx->tasks[task];
+        for (int r = 0; r < ctx->prefixDepth; r++) {
+            board[r] = ctx->prefixCols[task * (size_t)ctx->prefixDepth + (size_t)r];
         }
+
+        SolutionBuffer *out = (ctx->buffers != NULL) ? &ctx->buffers[task] : NULL;
+        uint64_t solutionsBefore = local.solutions;
+        uint64_t nodesBefore = local.nodes;
+
+        countSubtree(ctx, ctx->prefixDepth, t->cols, t->diag, t->anti, board, &local, out);
+
+        ctx->taskSolutions[task] = local.solutions - solutionsBefore;
+        ctx->taskNodes[task] = local.nodes - nodesBefore;
+        __atomic_store_n(&ctx->taskDone[task], 1, __ATOMIC_RELEASE);
     }
 
-    return bestName;
+    ctx->counters[wa->id] = local;
+
+    pthread_mutex_lock(&ctx->finishLock);
+    ctx->finishedWorkers++;
+    pthread_cond_signal(&ctx->finishCond);
+    pthread_mutex_unlock(&ctx->finishLock);
+    return NULL;
+}
+
+// Файл контрольной точки: заголовок, признаки выполнения задач, счетчики задач и контрольная сумма.
+// Пишется во временный файл и переименовывается, поэтому на диске всегда целая предыдущая или новая точка.
+
+#define CHECKPOINT_MAGIC "NQCKPT01"
+#define CHECKPOINT_TASKS 16384    // задач при записи контрольных точек: не зависит от числа потоков
+#define DEFAULT_CHECKPOINT_INTERVAL 30
+
+static uint64_t checksumBytes(const uint8_t *data, size_t len)
+{
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
 }
 
-static void printBestSummary(const SearchStats *bfsStats, const SearchStats *dfsIterStats, const SearchStats *dfsRecStats, const SearchStats *dfsPathStats)
+static size_t checkpointSize(size_t taskCount)
 {
-    const char *bestName = bestBySteps(bfsStats, dfsIterStats, dfsRecStats, dfsPathStats);
+    return 8 + 4 * sizeof(int32_t) + sizeof(uint64_t) + taskCount * (1 + 2 * sizeof(uint64_t)) + sizeof(uint64_t);
+}
 
-    printf("=== Сравнение методов по числу шагов до первого решения ===\n");
-    if (bestName != NULL) {
-        printf("Лучший метод: %s\n\n", bestName);
-    } else {
-        printf("Лучший метод: не определен, решений не найдено.\n\n");
+static uint8_t *putBytes(uint8_t *p, const void *src, size_t len)
+{
+    memcpy(p, src, len);
+    return p + len;
+}
+
+static bool writeCheckpoint(const ParallelContext *ctx, const char *path)
+{
+    size_t size = checkpointSize(ctx->taskCount);
+    uint8_t *data = (uint8_t *)allocOrDie(size);
+    uint8_t *p = data;
+    int32_t header[4] = {1, ctx->N, ctx->Q, ctx->prefixDepth};
+    uint64_t taskCount = ctx->taskCount;
+
+    p = putBytes(p, CHECKPOINT_MAGIC, 8);
+    p = putBytes(p, header, sizeof(header));
+    p = putBytes(p, &taskCount, sizeof(taskCount));
+
+    // Сначала признак, потом счетчики: у выполненной задачи счетчики уже записаны
+    uint8_t *done = p;
+    uint64_t *solutions = (uint64_t *)allocOrDie(ctx->taskCount * sizeof(uint64_t) + 1);
+    uint64_t *nodes = (uint64_t *)allocOrDie(ctx->taskCount * sizeof(uint64_t) + 1);
+    for (size_t t = 0; t < ctx->taskCount; t++) {
+        done[t] = __atomic_load_n(&ctx->taskDone[t], __ATOMIC_ACQUIRE);
+        solutions[t] = done[t] ? ctx->taskSolutions[t] : 0;
+        nodes[t] = done[t] ? ctx->taskNodes[t] : 0;
+    }
+    p += ctx->taskCount;
+    p = putBytes(p, solutions, ctx->taskCount * sizeof(uint64_t));
+    p = putBytes(p, nodes, ctx->taskCount * sizeof(uint64_t));
+    free(solutions);
+    free(nodes);
+
+    uint64_t sum = checksumBytes(data, (size_t)(p - data));
+    p = putBytes(p, &sum, sizeof(sum));
+
+    char tmpPath[4096];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", path);
+
+    FILE *f = fopen(tmpPath, "wb");
+    bool ok = f != NULL && fwrite(data, 1, size, f) == size && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    if (f != NULL && fclose(f) != 0) {
+        ok = false;
+    }
+    if (ok && rename(tmpPath, path) != 0) {
+        ok = false;
     }
+
+    if (!ok) {
+        fprintf(stderr, "Ошибка записи контрольной точки %s: %s\n", path, strerror(errno));
+        remove(tmpPath);
+    }
+
+    free(data);
+    return ok;
 }
 
-static void printNoSolutionIfNeeded(const char *methodName, int N, int Q, const SearchStats *stats)
+// Загрузка точки в taskDone/taskSolutions/taskNodes; false - файла нет.
+// Файл от другой задачи или поврежденный файл - ошибка: продолжать с него нельзя.
+static bool readCheckpoint(ParallelContext *ctx, const char *path)
 {
-    if (stats->solutionCount == 0) {
-        printf("%s: для N=%d, Q=%d решений не найдено.\n\n", methodName, N, Q);
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return false;
+    }
+
+    size_t size = checkpointSize(ctx->taskCount);
+    uint8_t *data = (uint8_t *)allocOrDie(size + 1);
+    size_t got = fread(data, 1, size + 1, f);
+    fclose(f);
+
+    int32_t header[4];
+    uint64_t taskCount;
+    uint64_t sum;
+    const uint8_t *p = data + 8;
+
+    if (got != size || memcmp(data, CHECKPOINT_MAGIC, 8) != 0) {
+        fprintf(stderr, "Ошибка: %s не является контрольной точкой этой задачи.\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    memcpy(header, p, sizeof(header));
+    p += sizeof(header);
+    memcpy(&taskCount, p, sizeof(taskCount));
+    p += sizeof(taskCount);
+    memcpy(&sum, data + size - sizeof(sum), sizeof(sum));
+
+    if (sum != checksumBytes(data, size - sizeof(sum))) {
+        fprintf(stderr, "Ошибка: контрольная сумма файла %s не совпадает.\n", path);
+        exit(EXIT_FAILURE);
+    }
+    if (header[0] != 1 || header[1] != ctx->N || header[2] != ctx->Q || header[3] != ctx->prefixDepth || taskCount != ctx->taskCount) {
+        fprintf(stderr, "Ошибка: контрольная точка %s записана для другой задачи (N = %d, Q = %d).\n", path, header[1], header[2]);
+        exit(EXIT_FAILURE);
     }
+
+    memcpy(ctx->taskDone, p, ctx->taskCount);
+    p += ctx->taskCount;
+    memcpy(ctx->taskSolutions, p, ctx->taskCount * sizeof(uint64_t));
+    p += ctx->taskCount * sizeof(uint64_t);
+    memcpy(ctx->taskNodes, p, ctx->taskCount * sizeof(uint64_t));
+
+    free(data);
+    return true;
 }
 
-int main(void)
+// Разворачивание дерева по уровням, пока задач не станет достаточно для всех потоков.
+// Порядок задач совпадает с порядком обхода DFS, поэтому перечисление выводит решения в том же порядке.
+static size_t buildPrefixTasks(ParallelContext *ctx, size_t target, PrefixTask **tasksOut, uint8_t **colsOut, uint64_t *prefixNodes)
 {
-    printf("=== Задача о N ферзях ===\n");
-    printf("Поиск решения в неявном графе пространства состояний\n\n");
+    size_t count = 1;
+    int depth = 0;
 
-    int N = readInt("Введите размерность доски N (1..12): ", 1, 12);
-    int Q = readInt("Введите число ферзей Q (1..N):       ", 1, N);
+    PrefixTask *tasks = (PrefixTask *)allocOrDie(sizeof(PrefixTask));
+    trackAllocation(&ctx->memory, sizeof(PrefixTask));
+    uint8_t *cols = (uint8_t *)allocOrDie(1);
+    trackAllocation(&ctx->memory, 1);
+    tasks[0].cols = 0;
+    tasks[0].diag = 0;
+    tasks[0].anti = 0;
 
-    printf("\nВыберите метод поиска:\n");
-    printf("1 - Поиск в ширину (BFS)\n");
-    printf("2 - Поиск в глубину, итерационный (DFS)\n");
-    printf("3 - Поиск в глубину, рекурсивный\n");
-    printf("4 - Поиск в глубину, рекурсивный с Path\n");
-    printf("5 - Выполнить все методы и сравнить\n\n");
+    *prefixNodes = 0;
 
-    int method = readInt("Ваш выбор (1..5): ", 1, 5);
+    while (count < target && depth < ctx->Q) {
+        size_t nextCount = 0;
+        for (size_t i = 0; i < count; i++) {
+            nextCount += (size_t)__builtin_popcount(~(tasks[i].cols | tasks[i].diag | tasks[i].anti) & ctx->mask);
+        }
 
-    int maxDepth = Q;
-    if (method == METHOD_DFS_ITER || method == METHOD_DFS_REC || method == METHOD_DFS_REC_PATH || method == METHOD_ALL) {
-        printf("\nДля DFS используется ограниченный перебор в глубину.\n");
-        maxDepth = readInt("Введите максимальную глубину просмотра (1..Q): ", 1, Q);
+        PrefixTask *nextTasks = (PrefixTask *)allocOrDie(nextCount * sizeof(PrefixTask));
+        trackAllocation(&ctx->memory, nextCount * sizeof(PrefixTask));
+        uint8_t *nextCols = (uint8_t *)allocOrDie(nextCount * (size_t)(depth + 1));
+        trackAllocation(&ctx->memory, nextCount * (size_t)(depth + 1));
+        size_t n = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            uint32_t freeCols = ~(tasks[i].cols | tasks[i].diag | tasks[i].anti) & ctx->mask;
+
+            while (freeCols != 0) {
+                uint32_t bit = freeCols & (0u - freeCols);
+                freeCols ^= bit;
+
+                for (int r = 0; r < depth; r++) {
+                    nextCols[n * (size_t)(depth + 1) + (size_t)r] = cols[i * (size_t)depth + (size_t)r];
+                }
+                nextCols[n * (size_t)(depth + 1) + (size_t)depth] = (uint8_t)__builtin_ctz(bit);
+
+                nextTasks[n].cols = tasks[i].cols | bit;
+                nextTasks[n].diag = ((tasks[i].diag | bit) << 1) & ctx->mask;
+                nextTasks[n].anti = (tasks[i].anti | bit) >> 1;
+                n++;
+            }
+        }
+
+        // Раскрытые вершины префикса тоже входят в число раскрытых состояний
+        *prefixNodes += count;
+
+        // Столбцы корня заняли один байт
+        trackFree(&ctx->memory, count * sizeof(PrefixTask) + (depth > 0 ? count * (size_t)depth : 1));
+        free(tasks);
+        free(cols);
+        tasks = nextTasks;
+        cols = nextCols;
+        count = nextCount;
+        depth++;
+
+        if (count == 0) {
+            break;
+        }
     }
 
-    SearchStats bfsStats;
-    SearchStats dfsIterStats;
-    SearchStats dfsRecStats;
-    SearchStats dfsPathStats;
+    ctx->prefixDepth = depth;
+    *tasksOut = tasks;
+    *colsOut = cols;
+    return count;
+}
 
-    bool hasBFS = false;
-    bool hasDFSIter = false;
-    bool hasDFSRec = false;
-    bool hasDFSPath = false;
+// Запуск потоков над невыполненными задачами ctx->order[0..pending-1]; итоги задач - в ctx->task*.
+// Если задан файл контрольной точки, главный поток раз в интервал сохраняет ход подсчета.
+static void runWorkers(ParallelContext *ctx, size_t pending, const CheckpointConfig *ckpt, ParallelStats *stats)
+{
+    int threads = ctx->threads;
+    bool checkpointing = ckpt != NULL && ckpt->path != NULL;
+
+    ctx->deques = (TaskDeque *)allocOrDie((size_t)threads * sizeof(TaskDeque));
+    trackAllocation(&ctx->memory, (size_t)threads * sizeof(TaskDeque));
+    ctx->counters = (WorkerCounters *)allocOrDie((size_t)threads * sizeof(WorkerCounters));
+    trackAllocation(&ctx->memory, (size_t)threads * sizeof(WorkerCounters));
+    ctx->finishedWorkers = 0;
+    pthread_mutex_init(&ctx->finishLock, NULL);
+    pthread_cond_init(&ctx->finishCond, NULL);
+
+    // Начальная раздача: каждому потоку непрерывный диапазон задач
+    for (int t = 0; t < threads; t++) {
+        pthread_mutex_init(&ctx->deques[t].lock, NULL);
+        ctx->deques[t].head = pending * (size_t)t / (size_t)threads;
+        ctx->deques[t].tail = pending * (size_t)(t + 1) / (size_t)threads;
+    }
 
-    if (method == METHOD_BFS || method == METHOD_ALL) {
-        printf("\n--- Поиск в ШИРИНУ (BFS) ---\n");
-        bfsStats = solveBFS(N, Q);
-        hasBFS = true;
-        printNoSolutionIfNeeded("BFS", N, Q, &bfsStats);
-        printStats("BFS", &bfsStats);
+    pthread_t *ids = (pthread_t *)allocOrDie((size_t)threads * sizeof(pthread_t));
+    trackAllocation(&ctx->memory, (size_t)threads * sizeof(pthread_t));
+    WorkerArg *args = (WorkerArg *)allocOrDie((size_t)threads * sizeof(WorkerArg));
+    trackAllocation(&ctx->memory, (size_t)threads * sizeof(WorkerArg));
+
+    for (int t = 0; t < threads; t++) {
+        args[t].ctx = ctx;
+        args[t].id = t;
+        if (pthread_create(&ids[t], NULL, parallelWorker, &args[t]) != 0) {
+            fprintf(stderr, "Ошибка создания потока.\n");
+            exit(EXIT_FAILURE);
+        }
     }
 
-    if (method == METHOD_DFS_ITER || method == METHOD_ALL) {
-        printf("\n--- Поиск в ГЛУБИНУ (DFS, итерационный, maxDepth=%d) ---\n", maxDepth);
-        dfsIterStats = solveDFSIterative(N, Q, maxDepth);
-        hasDFSIter = true;
-        printNoSolutionIfNeeded("DFS итерационный", N, Q, &dfsIterStats);
-        printStats("DFS итерационный", &dfsIterStats);
+    // Пока потоки считают, главный поток раз в интервал сохраняет контрольную точку
+    if (checkpointing) {
+        pthread_mutex_lock(&ctx->finishLock);
+        while (ctx->finishedWorkers < threads) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += ckpt->intervalSeconds;
+
+            while (ctx->finishedWorkers < threads &&
+                   pthread_cond_timedwait(&ctx->finishCond, &ctx->finishLock, &deadline) == 0) {
+            }
+
+            if (ctx->finishedWorkers < threads) {
+                pthread_mutex_unlock(&ctx->finishLock);
+                double writeStart = nowSeconds();
+                writeCheckpoint(ctx, ckpt->path);
+                stats->checkpointSeconds += nowSeconds() - writeStart;
+                stats->checkpoints++;
+                pthread_mutex_lock(&ctx->finishLock);
+            }
+        }
+        pthread_mutex_unlock(&ctx->finishLock);
     }
 
-    if (method == METHOD_DFS_REC || method == METHOD_ALL) {
-        printf("\n--- Поиск в ГЛУБИНУ (DFS, рекурсивный, maxDepth=%d) ---\n", maxDepth);
-        dfsRecStats = solveDFSRecursive(N, Q, maxDepth);
-        hasDFSRec = true;
-        printNoSolutionIfNeeded("DFS рекурсивный", N, Q, &dfsRecStats);
-        printStats("DFS рекурсивный", &dfsRecStats);
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        stats->stolenTasks += ctx->counters[t].stolen;
     }
 
-    if (method == METHOD_DFS_REC_PATH || method == METHOD_ALL) {
-        printf("\n--- Поиск в ГЛУБИНУ (DFS, рекурсивный с Path, maxDepth=%d) ---\n", maxDepth);
-        dfsPathStats = solveDFSRecursiveWithPath(N, Q, maxDepth);
-        hasDFSPath = true;
-        printNoSolutionIfNeeded("DFS рекурсивный с Path", N, Q, &dfsPathStats);
-        printStats("DFS рекурсивный с Path", &dfsPathStats);
+    // Буферы решений растут в потоках; их выделения учитываются, когда потоки закончили
+    if (ctx->buffers != NULL) {
+        for (size_t t = 0; t < ctx->taskCount; t++) {
+            trackBytes(&ctx->memory, ctx->buffers[t].capacity * (size_t)ctx->Q);
+            ctx->memory.allocations += ctx->buffers[t].allocations;
+        }
     }
 
-    if (method == METHOD_ALL) {
-        printBestSummary(hasBFS ? &bfsStats : NULL, hasDFSIter ? &dfsIterStats : NULL, hasDFSRec ? &dfsRecStats : NULL, hasDFSPath ? &dfsPathStats : NULL);
+    if (checkpointing) {
+        double writeStart = nowSeconds();
+        writeCheckpoint(ctx, ckpt->path);
+        stats->checkpointSeconds += nowSeconds() - writeStart;
+        stats->checkpoints++;
+    }
+
+    // Очереди уничтожаются только после завершения всех потоков: чужие очереди читаются при краже
+    for (int t = 0; t < threads; t++) {
+        pthread_mutex_destroy(&ctx->deques[t].lock);
+    }
+    pthread_mutex_destroy(&ctx->finishLock);
+    pthread_cond_destroy(&ctx->finishCond);
+
+    trackFree(&ctx->memory, (size_t)threads * (sizeof(TaskDeque) + sizeof(WorkerCounters) + sizeof(pthread_t) + sizeof(WorkerArg)));
+    free(ids);
+    free(args);
+    free(ctx->deques);
+    free(ctx->counters);
+    ctx->deques = NULL;
+    ctx->counters = NULL;
+}
+
+// Массивы итогов по задачам; taskDone у всех задач изначально нулевой
+static void allocTaskResults(ParallelContext *ctx)
+{
+    ctx->taskDone = (uint8_t *)calloc(ctx->taskCount + 1, 1);
+    ctx->taskSolutions = (uint64_t *)calloc(ctx->taskCount + 1, sizeof(uint64_t));
+    ctx->taskNodes = (uint64_t *)calloc(ctx->taskCount + 1, sizeof(uint64_t));
+
+    if (!ctx->taskDone || !ctx->taskSolutions || !ctx->taskNodes) {
+        fprintf(stderr, "Ошибка выделения памяти для итогов задач.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    trackAllocation(&ctx->memory, ctx->taskCount + 1);
+    trackAllocation(&ctx->memory, (ctx->taskCount + 1) * sizeof(uint64_t));
+    trackAllocation(&ctx->memory, (ctx->taskCount + 1) * sizeof(uint64_t));
+}
+
+static void freeTaskResults(ParallelContext *ctx)
+{
+    trackFree(&ctx->memory, (ctx->taskCount + 1) * (1 + 2 * sizeof(uint64_t)));
+    free(ctx->taskDone);
+    free(ctx->taskSolutions);
+    free(ctx->taskNodes);
+    ctx->taskDone = NULL;
+    ctx->taskSolutions = NULL;
+    ctx->taskNodes = NULL;
+}
+
+static ParallelStats solveParallel(int N, int Q, int threads, const CheckpointConfig *ckpt, SolutionOutput *out)
+{
+    bool enumerate = out->mode != OUTPUT_COUNT;
+    ParallelContext ctx = {0};
+    ParallelStats stats = {0};
+    PrefixTask *tasks;
+    uint8_t *prefixCols;
+    uint64_t prefixNodes;
+
+    double start = nowSeconds();
+
+    ctx.N = N;
+    ctx.Q = Q;
+    ctx.mask = fullMask(N);
+    ctx.threads = threads;
+    bool checkpointing = ckpt != NULL && ckpt->path != NULL;
+    size_t target = checkpointing ? CHECKPOINT_TASKS : (size_t)threads * TASKS_PER_THREAD;
+
+    ctx.taskCount = buildPrefixTasks(&ctx, target, &tasks, &prefixCols, &prefixNodes);
+    ctx.tasks = tasks;
+    ctx.prefixCols = prefixCols;
+    allocTaskResults(&ctx);
+
+    if (checkpointing && ckpt->resume && readCheckpoint(&ctx, ckpt->path)) {
+        for (size_t t = 0; t < ctx.taskCount; t++) {
+            stats.resumedTasks += ctx.taskDone[t];
+        }
+    }
+
+    // В очереди попадают только невыполненные задачи, в исходном порядке
+    size_t *order = (size_t *)allocOrDie((ctx.taskCount + 1) * sizeof(size_t));
+    trackAllocation(&ctx.memory, (ctx.taskCount + 1) * sizeof(size_t));
+    size_t pending = 0;
+    for (size_t t = 0; t < ctx.taskCount; t++) {
+        if (!ctx.taskDone[t]) {
+            order[pending++] = t;
+        }
+    }
+    ctx.order = order;
+    ctx.buffers = enumerate ? (SolutionBuffer *)calloc(ctx.taskCount ? ctx.taskCount : 1, sizeof(SolutionBuffer)) : NULL;
+
+    if (enumerate && ctx.buffers == NULL) {
+        fprintf(stderr, "Ошибка выделения памяти для буферов решений.\n");
+        exit(EXIT_FAILURE);
+    }
+    if (enumerate) {
+        trackAllocation(&ctx.memory, (ctx.taskCount ? ctx.taskCount : 1) * sizeof(SolutionBuffer));
+    }
+
+    runWorkers(&ctx, pending, ckpt, &stats);
+
+    // Итог - сумма по задачам: так учитываются и задачи, посчитанные до возобновления
+    stats.expandedStates = prefixNodes;
+    for (size_t t = 0; t < ctx.taskCount; t++) {
+        stats.solutionCount += ctx.taskSolutions[t];
+        stats.expandedStates += ctx.taskNodes[t];
+    }
+
+    stats.seconds = nowSeconds() - start;
+    stats.taskCount = ctx.taskCount;
+    stats.prefixDepth = ctx.prefixDepth;
+    stats.threads = threads;
+
+    if (enumerate) {
+        uint64_t printed = 0;
+        int *board = (int *)allocOrDie((size_t)N * sizeof(int));
+        trackAllocation(&ctx.memory, (size_t)N * sizeof(int));
+
+        for (size_t t = 0; t < ctx.taskCount; t++) {
+            for (size_t i = 0; i < ctx.buffers[t].count; i++) {
+                for (int r = 0; r < N; r++) {
+                    board[r] = (r < Q) ? ctx.buffers[t].cols[i * (size_t)Q + (size_t)r] : -1;
+                }
+                printSolutionByBoard(out, board, Q, N, &printed);
+            }
+            free(ctx.buffers[t].cols);
+        }
+
+        free(board);
+        free(ctx.buffers);
+        flushOutput(out);
+    }
+
+    free(tasks);
+    free(prefixCols);
+    free(order);
+    freeTaskResults(&ctx);
+
+    stats.peakBytes = ctx.memory.peakBytes;
+    stats.allocations = ctx.memory.allocations;
+    return stats;
+}
+
+static void printParallelStats(const ParallelStats *stats)
+{
+    printf("Параллельный DFS: всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 "\n",
+           stats->solutionCount, stats->expandedStates);
+    printf("Параллельный DFS: потоков = %d | задач = %zu (префикс %d строк) | украдено задач = %" PRIu64 " | время = %.3f с\n\n",
+           stats->threads, stats->taskCount, stats->prefixDepth, stats->stolenTasks, stats->seconds);
+
+    if (stats->checkpoints > 0) {
+        printf("Контрольные точки: записано = %d | время записи = %.3f с (%.2f%%) | задач до возобновления = %zu\n\n",
+               stats->checkpoints, stats->checkpointSeconds,
+               stats->seconds > 0.0 ? 100.0 * stats->checkpointSeconds / stats->seconds : 0.0, stats->resumedTasks);
+    }
+}
+
+// Параллельный BFS по слоям: потоки раскрывают свои срезы текущего слоя в собственные буферы,
+// дубликаты отсеиваются общим хеш-множеством без блокировок, а выжившие потомки копируются
+// в следующий слой по префиксным суммам. Срезы идут в порядке слоя, поэтому следующий слой
+// совпадает с очередью обычного BFS, и счетчики с порядком решений не зависят от числа потоков.
+
+#define BFS_KEY_SHIFT 40          // ключ ячейки: номер потока в старших битах, индекс потомка в младших
+
+static uint64_t hashBoardBytes(const uint8_t *board, int depth)
+{
+    // FNV-1a по глубине и префиксу доски, как в hashState
+    uint64_t h = 1469598103934665603ULL;
+
+    h = (h ^ (uint64_t)(uint32_t)depth) * 1099511628211ULL;
+    for (int i = 0; i < depth; i++) {
+        h = (h ^ (uint64_t)board[i]) * 1099511628211ULL;
+    }
+
+    return h ^ (h >> 29);
+}
+
+static void pushChild(ChildBuffer *buf, const FrontierState *s, const uint8_t *board, int depth)
+{
+    if (buf->size == buf->capacity) {
+        size_t capacity = buf->capacity ? buf->capacity * 2 : 1024;
+        FrontierState *states = (FrontierState *)realloc(buf->states, capacity * sizeof(FrontierState));
+        if (states) {
+            buf->states = states;
+        }
+        uint8_t *boards = (uint8_t *)realloc(buf->boards, capacity * (size_t)depth);
+        if (!states || !boards) {
+            fprintf(stderr, "Ошибка выделения памяти для параллельного BFS.\n");
+            exit(EXIT_FAILURE);
+        }
+
+        buf->boards = boards;
+        buf->capacity = capacity;
+        buf->allocations += 2;
+    }
+
+    buf->states[buf->size] = *s;
+    memcpy(buf->boards + buf->size * (size_t)depth, board, (size_t)depth);
+    buf->size++;
+}
+
+// Фаза 1: порождение потомков своего среза слоя
+static void expandSlice(BfsContext *ctx, int id)
+{
+    ChildBuffer *buf = &ctx->children[id];
+    int depth = ctx->depth;
+    uint32_t mask = fullMask(ctx->N);
+    size_t begin = ctx->layerSize * (size_t)id / (size_t)ctx->threads;
+    size_t end = ctx->layerSize * (size_t)(id + 1) / (size_t)ctx->threads;
+    uint8_t board[MAX_N];
+
+    // Буфер переходит со слоя на слой, а доски потомков с каждым слоем длиннее на байт
+    buf->size = 0;
+    if (buf->capacity > 0) {
+        uint8_t *boards = (uint8_t *)realloc(buf->boards, buf->capacity * ((size_t)depth + 1));
+        if (!boards) {
+            fprintf(stderr, "Ошибка выделения памяти для параллельного BFS.\n");
+            exit(EXIT_FAILURE);
+        }
+        buf->boards = boards;
+        buf->allocations++;
+    }
+
+    for (size_t i = begin; i < end; i++) {
+        const FrontierState *parent = &ctx->layer[i];
+        memcpy(board, ctx->boards + i * (size_t)depth, (size_t)depth);
+
+        uint32_t freeCols = ~(parent->cols | parent->diag | parent->anti) & mask;
+        while (freeCols != 0) {
+            int col = __builtin_ctz(freeCols);
+            uint32_t bit = 1u << col;
+            freeCols &= freeCols - 1;
+
+            FrontierState child;
+            child.cols = parent->cols | bit;
+            child.diag = ((parent->diag | bit) << 1) & mask;
+            child.anti = (parent->anti | bit) >> 1;
+            board[depth] = (uint8_t)col;
+            child.hash = hashBoardBytes(board, depth + 1);
+            child.slot = 0;
+            pushChild(buf, &child, board, depth + 1);
+        }
+    }
+}
+
+static bool sameChild(const BfsContext *ctx, uint64_t key, const FrontierState *s, const uint8_t *board, int depth)
+{
+    const ChildBuffer *other = &ctx->children[(key - 1) >> BFS_KEY_SHIFT];
+    size_t idx = (size_t)((key - 1) & ((1ULL << BFS_KEY_SHIFT) - 1));
+
+    return other->states[idx].hash == s->hash && memcmp(other->boards + idx * (size_t)depth, board, (size_t)depth) == 0;
+}
+
+// Фаза 2: вставка потомков в общее хеш-множество слоя (открытая адресация, CAS без блокировок).
+// Буферы всех потоков после фазы 1 не меняются, поэтому ячейка хранит лишь ключ потомка.
+static void insertSlice(BfsContext *ctx, int id)
+{
+    ChildBuffer *buf = &ctx->children[id];
+    int depth = ctx->depth + 1;
+
+    for (size_t i = 0; i < buf->size; i++) {
+        FrontierState *s = &buf->states[i];
+        const uint8_t *board = buf->boards + i * (size_t)depth;
+        uint64_t key = (((uint64_t)id << BFS_KEY_SHIFT) | i) + 1;
+        size_t pos = (size_t)s->hash & ctx->slotMask;
+
+        while (1) {
+            uint64_t cur = __atomic_load_n(&ctx->slots[pos], __ATOMIC_ACQUIRE);
+
+            if (cur == 0) {
+                if (__atomic_compare_exchange_n(&ctx->slots[pos], &cur, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    break;
+                }
+                continue;     // ячейку только что заняли: проверяем ее заново
+            }
+
+            if (sameChild(ctx, cur, s, board, depth)) {
+                // Из равных состояний остается первое в порядке слоя, а не победитель гонки
+                if (key < cur && !__atomic_compare_exchange_n(&ctx->slots[pos], &cur, key, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                    continue;
+                }
+                break;
+            }
+
+            pos = (pos + 1) & ctx->slotMask;
+        }
+
+        s->slot = pos;
+    }
+}
+
+// Фаза 3: потомок выживает, если ячейка его состояния осталась за ним
+static void markSurvivors(BfsContext *ctx, int id)
+{
+    ChildBuffer *buf = &ctx->children[id];
+
+    buf->survivors = 0;
+    for (size_t i = 0; i < buf->size; i++) {
+        uint64_t key = (((uint64_t)id << BFS_KEY_SHIFT) | i) + 1;
+        if (ctx->slots[buf->states[i].slot] == key) {
+            buf->survivors++;
+        }
+    }
+}
+
+// Фаза 4: копирование выживших потомков в следующий слой со своего смещения
+static void copySurvivors(BfsContext *ctx, int id)
+{
+    ChildBuffer *buf = &ctx->children[id];
+    int depth = ctx->depth + 1;
+    size_t dst = buf->offset;
+
+    for (size_t i = 0; i < buf->size; i++) {
+        uint64_t key = (((uint64_t)id << BFS_KEY_SHIFT) | i) + 1;
+        if (ctx->slots[buf->states[i].slot] != key) {
+            continue;
+        }
+
+        ctx->nextLayer[dst] = buf->states[i];
+        memcpy(ctx->nextBoards + dst * (size_t)depth, buf->boards + i * (size_t)depth, (size_t)depth);
+        dst++;
+    }
+}
+
+// Поток проходит фазы слоя между барьерами; последовательные шаги между фазами делает главный поток
+static void *bfsWorker(void *arg)
+{
+    BfsWorkerArg *wa = (BfsWorkerArg *)arg;
+    BfsContext *ctx = wa->ctx;
+
+    while (1) {
+        pthread_barrier_wait(&ctx->barrier);      // слой готов
+        if (ctx->done) {
+            break;
+        }
+
+        expandSlice(ctx, wa->id);
+        pthread_barrier_wait(&ctx->barrier);      // потомки порождены
+        pthread_barrier_wait(&ctx->barrier);      // хеш-множество очищено
+        insertSlice(ctx, wa->id);
+        pthread_barrier_wait(&ctx->barrier);      // все потомки вставлены
+        markSurvivors(ctx, wa->id);
+        pthread_barrier_wait(&ctx->barrier);      // выжившие посчитаны
+        pthread_barrier_wait(&ctx->barrier);      // смещения и следующий слой готовы
+        copySurvivors(ctx, wa->id);
+        pthread_barrier_wait(&ctx->barrier);      // следующий слой заполнен
+    }
+
+    return NULL;
+}
+
+static SearchStats solveParallelBFS(int N, int Q, int threads, SolutionOutput *out)
+{
+    SearchStats stats;
+    BfsContext ctx;
+    size_t slotCapacity = 0;
+
+    initStats(&stats);
+    ctx.N = N;
+    ctx.threads = threads;
+    ctx.slots = NULL;
+    ctx.slotMask = 0;
+    ctx.done = false;
+    ctx.children = (ChildBuffer *)calloc((size_t)threads, sizeof(ChildBuffer));
+    if (!ctx.children) {
+        fprintf(stderr, "Ошибка выделения памяти для параллельного BFS.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Open = [Start]: слой 0 из одного пустого состояния
+    FrontierState *layer = (FrontierState *)allocOrDie(sizeof(FrontierState));
+    uint8_t *boards = (uint8_t *)allocOrDie(1);
+    size_t layerSize = 1;
+    layer[0].cols = 0;
+    layer[0].diag = 0;
+    layer[0].anti = 0;
+    layer[0].hash = hashBoardBytes(NULL, 0);
+    layer[0].slot = 0;
+    stats.allocations += 2;
+
+    if (pthread_barrier_init(&ctx.barrier, NULL, (unsigned)threads + 1) != 0) {
+        fprintf(stderr, "Ошибка создания барьера потоков.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_t *ids = (pthread_t *)allocOrDie((size_t)threads * sizeof(pthread_t));
+    BfsWorkerArg *args = (BfsWorkerArg *)allocOrDie((size_t)threads * sizeof(BfsWorkerArg));
+
+    for (int t = 0; t < threads; t++) {
+        args[t].ctx = &ctx;
+        args[t].id = t;
+        if (pthread_create(&ids[t], NULL, bfsWorker, &args[t]) != 0) {
+            fprintf(stderr, "Ошибка создания потока.\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int depth = 0;
+    while (depth < Q && layerSize > 0) {
+        ctx.depth = depth;
+        ctx.layer = layer;
+        ctx.boards = boards;
+        ctx.layerSize = layerSize;
+
+        // Все состояния слоя извлекаются из Open и раскрываются
+        stats.expandedStates += layerSize;
+
+        pthread_barrier_wait(&ctx.barrier);
+        pthread_barrier_wait(&ctx.barrier);
+
+        // Заполнение множества не выше 1/2, как у StateSet
+        size_t total = 0;
+        size_t childBytes = 0;
+        for (int t = 0; t < threads; t++) {
+            total += ctx.children[t].size;
+            childBytes += ctx.children[t].capacity * (sizeof(FrontierState) + (size_t)depth + 1);
+        }
+
+        size_t capacity = STATE_SET_INITIAL_CAPACITY;
+        while (capacity < total * 2) {
+            capacity *= 2;
+        }
+        if (capacity > slotCapacity) {
+            free(ctx.slots);
+            ctx.slots = (uint64_t *)allocOrDie(capacity * sizeof(uint64_t));
+            slotCapacity = capacity;
+            stats.allocations++;
+        }
+        memset(ctx.slots, 0, capacity * sizeof(uint64_t));
+        ctx.slotMask = capacity - 1;
+
+        pthread_barrier_wait(&ctx.barrier);
+        pthread_barrier_wait(&ctx.barrier);
+        pthread_barrier_wait(&ctx.barrier);
+
+        size_t nextSize = 0;
+        for (int t = 0; t < threads; t++) {
+            ctx.children[t].offset = nextSize;
+            nextSize += ctx.children[t].survivors;
+        }
+
+        ctx.nextLayer = (FrontierState *)allocOrDie(nextSize * sizeof(FrontierState));
+        ctx.nextBoards = (uint8_t *)allocOrDie(nextSize * ((size_t)depth + 1));
+        stats.allocations += 2;
+
+        size_t bytes = layerSize * (sizeof(FrontierState) + (size_t)depth) + childBytes +
+                       slotCapacity * sizeof(uint64_t) + nextSize * (sizeof(FrontierState) + (size_t)depth + 1);
+        if (bytes > stats.peakBytes) {
+            stats.peakBytes = bytes;
+        }
+
+        pthread_barrier_wait(&ctx.barrier);
+        pthread_barrier_wait(&ctx.barrier);
+
+        free(layer);
+        free(boards);
+        layer = ctx.nextLayer;
+        boards = ctx.nextBoards;
+        layerSize = nextSize;
+        depth++;
+    }
+
+    ctx.done = true;
+    pthread_barrier_wait(&ctx.barrier);
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        stats.allocations += ctx.children[t].allocations;
+        free(ctx.children[t].states);
+        free(ctx.children[t].boards);
+    }
+
+    // Целевой слой: состояния извлекаются в порядке очереди, как в solveBFS
+    if (depth == Q) {
+        int board[MAX_N];
+
+        // Строки без ферзей при Q < N
+        for (int r = Q; r < N; r++) {
+            board[r] = -1;
+        }
+
+        for (size_t i = 0; i < layerSize; i++) {
+            stats.expandedStates++;
+            registerSolutionStep(&stats);
+
+            for (int r = 0; r < Q; r++) {
+                board[r] = boards[i * (size_t)Q + (size_t)r];
+            }
+            printSolutionByBoard(out, board, Q, N, &stats.solutionCount);
+        }
+    }
+
+    pthread_barrier_destroy(&ctx.barrier);
+    free(ids);
+    free(args);
+    free(ctx.children);
+    free(ctx.slots);
+    free(layer);
+    free(boards);
+    flushOutput(out);
+    return stats;
+}
+
+// Распределенный подсчет через общую файловую систему: plan делит задачи-префиксы на шарды
+// и пишет файл задания, run-shard считает свой шард и пишет файл результата, merge проверяет
+// и складывает результаты. Файлы текстовые, поэтому не зависят от порядка байтов машины.
+
+#define JOB_MAGIC "NQJOB"
+#define RESULT_MAGIC "NQRESULT"
+#define SHARD_TASKS 256           // задач на шард: хватает, чтобы внутри шарда работали потоки
+#define MAX_SHARDS 65536
+
+// Задание: префиксы задач и номер шарда каждой задачи
+typedef struct {
+    int N;
+    int Q;
+    int prefixDepth;
+    int shards;
+    size_t taskCount;
+    uint64_t prefixNodes;
+    uint8_t *cols;            // по prefixDepth столбцов на задачу
+    int *shardOf;
+    uint64_t id;              // хеш содержимого файла: связывает результаты с заданием
+} ShardJob;
+
+typedef struct {
+    int shard;
+    size_t tasks;
+    uint64_t solutions;
+    uint64_t nodes;
+    double seconds;
+} ShardResult;
+
+// Файлы пишутся во временный файл и переименовываются: читатель на другой машине
+// видит либо старый файл, либо целый новый
+static FILE *beginAtomicWrite(const char *path, char *tmpPath, size_t size)
+{
+    snprintf(tmpPath, size, "%s.tmp", path);
+
+    FILE *f = fopen(tmpPath, "w");
+    if (f == NULL) {
+        fprintf(stderr, "Ошибка записи файла %s: %s\n", path, strerror(errno));
+    }
+    return f;
+}
+
+static bool commitAtomicWrite(FILE *f, const char *tmpPath, const char *path)
+{
+    bool ok = !ferror(f) && fflush(f) == 0 && fsync(fileno(f)) == 0;
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    if (ok && rename(tmpPath, path) != 0) {
+        ok = false;
+    }
+
+    if (!ok) {
+        fprintf(stderr, "Ошибка записи файла %s: %s\n", path, strerror(errno));
+        remove(tmpPath);
+    }
+    return ok;
+}
+
+static char *readWholeFile(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        fprintf(stderr, "Ошибка открытия файла %s: %s\n", path, strerror(errno));
+        return NULL;
+    }
+
+    size_t capacity = 4096;
+    size_t size = 0;
+    char *data = (char *)allocOrDie(capacity);
+
+    size_t got;
+    while ((got = fread(data + size, 1, capacity - size - 1, f)) > 0) {
+        size += got;
+        if (capacity - size - 1 == 0) {
+            capacity *= 2;
+            char *grown = (char *)realloc(data, capacity);
+            if (!grown) {
+                fprintf(stderr, "Ошибка выделения памяти для чтения файла.\n");
+                exit(EXIT_FAILURE);
+            }
+            data = grown;
+        }
+    }
+    fclose(f);
+
+    data[size] = '\0';
+    *len = size;
+    return data;
+}
+
+static bool planShards(int N, int Q, int shards, const char *jobPath)
+{
+    ParallelContext ctx = {0};
+    PrefixTask *tasks;
+    uint8_t *prefixCols;
+    uint64_t prefixNodes;
+
+    ctx.N = N;
+    ctx.Q = Q;
+    ctx.mask = fullMask(N);
+    size_t taskCount = buildPrefixTasks(&ctx, (size_t)shards * SHARD_TASKS, &tasks, &prefixCols, &prefixNodes);
+
+    char tmpPath[4096];
+    FILE *f = beginAtomicWrite(jobPath, tmpPath, sizeof(tmpPath));
+    bool ok = f != NULL;
+
+    if (ok) {
+        fprintf(f, JOB_MAGIC " 1\nn %d\nq %d\nprefix_depth %d\nprefix_nodes %" PRIu64 "\ntasks %zu\nshards %d\n",
+                N, Q, ctx.prefixDepth, prefixNodes, taskCount, shards);
+
+        // Задачи раздаются по кругу: соседние префиксы близки по объему, так шарды выравниваются
+        for (size_t t = 0; t < taskCount; t++) {
+            fprintf(f, "task %zu", t % (size_t)shards);
+            for (int r = 0; r < ctx.prefixDepth; r++) {
+                fprintf(f, " %d", prefixCols[t * (size_t)ctx.prefixDepth + (size_t)r]);
+            }
+            fputc('\n', f);
+        }
+        fputs("end\n", f);
+
+        ok = commitAtomicWrite(f, tmpPath, jobPath);
+    }
+
+    if (ok) {
+        printf("План: N = %d | Q = %d | задач = %zu (префикс %d строк) | шардов = %d | файл задания: %s\n",
+               N, Q, taskCount, ctx.prefixDepth, shards, jobPath);
+    }
+
+    free(tasks);
+    free(prefixCols);
+    return ok;
+}
+
+static void freeShardJob(ShardJob *job)
+{
+    free(job->cols);
+    free(job->shardOf);
+    job->cols = NULL;
+    job->shardOf = NULL;
+}
+
+// Разбор задания с проверкой каждого префикса: столбцы не должны бить друг друга
+static bool readShardJob(const char *path, ShardJob *job)
+{
+    size_t len;
+    char *data = readWholeFile(path, &len);
+    if (data == NULL) {
+        return false;
+    }
+
+    job->id = checksumBytes((const uint8_t *)data, len);
+    job->cols = NULL;
+    job->shardOf = NULL;
+
+    char *p = data;
+    int version, consumed;
+    long long prefixNodes, taskCount;
+    bool ok = sscanf(p, JOB_MAGIC " %d n %d q %d prefix_depth %d prefix_nodes %lld tasks %lld shards %d%n",
+                     &version, &job->N, &job->Q, &job->prefixDepth, &prefixNodes, &taskCount, &job->shards, &consumed) == 7;
+
+    ok = ok && version == 1 && job->N >= 1 && job->N <= MAX_N && job->Q >= 1 && job->Q <= job->N &&
+         job->prefixDepth >= 0 && job->prefixDepth <= job->Q && taskCount >= 0 && prefixNodes >= 0 &&
+         job->shards >= 1 && job->shards <= MAX_SHARDS;
+
+    if (ok) {
+        job->prefixNodes = (uint64_t)prefixNodes;
+        job->taskCount = (size_t)taskCount;
+        job->cols = (uint8_t *)allocOrDie(job->taskCount * (size_t)job->prefixDepth + 1);
+        job->shardOf = (int *)allocOrDie((job->taskCount + 1) * sizeof(int));
+        p += consumed;
+    }
+
+    uint32_t mask = ok ? fullMask(job->N) : 0;
+    for (size_t t = 0; ok && t < job->taskCount; t++) {
+        uint32_t cols = 0, diag = 0, anti = 0;
+
+        ok = sscanf(p, " task %d%n", &job->shardOf[t], &consumed) == 1 && job->shardOf[t] >= 0 && job->shardOf[t] < job->shards;
+        p += ok ? consumed : 0;
+
+        for (int r = 0; ok && r < job->prefixDepth; r++) {
+            int col;
+            ok = sscanf(p, " %d%n", &col, &consumed) == 1 && col >= 0 && col < job->N;
+            if (ok) {
+                uint32_t bit = 1u << col;
+                ok = ((cols | diag | anti) & bit) == 0;
+                cols |= bit;
+                diag = ((diag | bit) << 1) & mask;
+                anti = (anti | bit) >> 1;
+                job->cols[t * (size_t)job->prefixDepth + (size_t)r] = (uint8_t)col;
+                p += consumed;
+            }
+        }
+    }
+
+    char tail[8] = "";
+    ok = ok && sscanf(p, " %7s", tail) == 1 && strcmp(tail, "end") == 0;
+
+    free(data);
+    if (!ok) {
+        fprintf(stderr, "Ошибка: %s не является корректным файлом задания.\n", path);
+        freeShardJob(job);
+    }
+    return ok;
+}
+
+static bool runShard(const char *jobPath, int shard, int threads, const char *resultPath)
+{
+    ShardJob job;
+    if (!readShardJob(jobPath, &job)) {
+        return false;
+    }
+    if (shard < 0 || shard >= job.shards) {
+        fprintf(stderr, "Номер шарда должен быть в диапазоне 0..%d\n", job.shards - 1);
+        freeShardJob(&job);
+        return false;
+    }
+
+    double start = nowSeconds();
+    ParallelContext ctx = {0};
+    ParallelStats stats = {0};
+
+    ctx.N = job.N;
+    ctx.Q = job.Q;
+    ctx.mask = fullMask(job.N);
+    ctx.threads = threads;
+    ctx.prefixDepth = job.prefixDepth;
+    ctx.taskCount = job.taskCount;
+    ctx.prefixCols = job.cols;
+    ctx.buffers = NULL;
+    allocTaskResults(&ctx);
+
+    // Маски задач восстанавливаются по столбцам префикса
+    PrefixTask *tasks = (PrefixTask *)allocOrDie((job.taskCount + 1) * sizeof(PrefixTask));
+    size_t *order = (size_t *)allocOrDie((job.taskCount + 1) * sizeof(size_t));
+    size_t pending = 0;
+
+    for (size_t t = 0; t < job.taskCount; t++) {
+        tasks[t].cols = 0;
+        tasks[t].diag = 0;
+        tasks[t].anti = 0;
+        for (int r = 0; r < job.prefixDepth; r++) {
+            uint32_t bit = 1u << job.cols[t * (size_t)job.prefixDepth + (size_t)r];
+            tasks[t].cols |= bit;
+            tasks[t].diag = ((tasks[t].diag | bit) << 1) & ctx.mask;
+            tasks[t].anti = (tasks[t].anti | bit) >> 1;
+        }
+        if (job.shardOf[t] == shard) {
+            order[pending++] = t;
+        }
+    }
+    ctx.tasks = tasks;
+    ctx.order = order;
+
+    runWorkers(&ctx, pending, NULL, &stats);
+
+    ShardResult result = {shard, pending, 0, 0, 0.0};
+    for (size_t k = 0; k < pending; k++) {
+        result.solutions += ctx.taskSolutions[order[k]];
+        result.nodes += ctx.taskNodes[order[k]];
+    }
+    result.seconds = nowSeconds() - start;
+
+    char text[512];
+    int len = snprintf(text, sizeof(text),
+                       RESULT_MAGIC " 1\njob %016" PRIx64 "\nshard %d\nshards %d\ntasks %zu\nsolutions %" PRIu64 "\nnodes %" PRIu64 "\nseconds %.3f\n",
+                       job.id, result.shard, job.shards, result.tasks, result.solutions, result.nodes, result.seconds);
+    len += snprintf(text + len, sizeof(text) - (size_t)len, "check %016" PRIx64 "\n", checksumBytes((const uint8_t *)text, (size_t)len));
+
+    char tmpPath[4096];
+    FILE *f = beginAtomicWrite(resultPath, tmpPath, sizeof(tmpPath));
+    bool ok = f != NULL;
+    if (ok) {
+        fputs(text, f);
+        ok = commitAtomicWrite(f, tmpPath, resultPath);
+    }
+
+    if (ok) {
+        printf("Шард %d из %d: задач = %zu | решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | время = %.3f с\n",
+               shard, job.shards, result.tasks, result.solutions, result.nodes, result.seconds);
+    }
+
+    free(tasks);
+    free(order);
+    freeTaskResults(&ctx);
+    freeShardJob(&job);
+    return ok;
+}
+
+static bool readShardResult(const char *path, const ShardJob *job, ShardResult *result)
+{
+    size_t len;
+    char *data = readWholeFile(path, &len);
+    if (data == NULL) {
+        return false;
+    }
+
+    int version, shards, consumed;
+    uint64_t jobId, check;
+    bool ok = sscanf(data, RESULT_MAGIC " %d job %" SCNx64 " shard %d shards %d tasks %zu solutions %" SCNu64 " nodes %" SCNu64 " seconds %lf%n",
+                     &version, &jobId, &result->shard, &shards, &result->tasks, &result->solutions, &result->nodes, &result->seconds, &consumed) == 8;
+
+    // Контрольная сумма покрывает все строки до строки check
+    if (ok) {
+        size_t body = (size_t)consumed + 1;
+        ok = body <= len && sscanf(data + body, "check %" SCNx64, &check) == 1 &&
+             check == checksumBytes((const uint8_t *)data, body);
+    }
+
+    free(data);
+
+    if (!ok || version != 1) {
+        fprintf(stderr, "Ошибка: %s не является корректным файлом результата.\n", path);
+        return false;
+    }
+    if (jobId != job->id || shards != job->shards) {
+        fprintf(stderr, "Ошибка: результат %s получен для другого задания.\n", path);
+        return false;
+    }
+    if (result->shard < 0 || result->shard >= job->shards) {
+        fprintf(stderr, "Ошибка: в %s неверный номер шарда %d.\n", path, result->shard);
+        return false;
+    }
+    return true;
+}
+
+static bool mergeShards(const char *jobPath, char **resultPaths, int resultCount)
+{
+    ShardJob job;
+    if (!readShardJob(jobPath, &job)) {
+        return false;
+    }
+
+    size_t *expectedTasks = (size_t *)calloc((size_t)job.shards, sizeof(size_t));
+    const char **seen = (const char **)calloc((size_t)job.shards, sizeof(const char *));
+    if (!expectedTasks || !seen) {
+        fprintf(stderr, "Ошибка выделения памяти для слияния.\n");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t t = 0; t < job.taskCount; t++) {
+        expectedTasks[job.shardOf[t]]++;
+    }
+
+    bool ok = true;
+    uint64_t solutions = 0;
+    uint64_t nodes = job.prefixNodes;
+    double seconds = 0.0;
+
+    for (int i = 0; i < resultCount; i++) {
+        ShardResult result;
+        if (!readShardResult(resultPaths[i], &job, &result)) {
+            ok = false;
+            continue;
+        }
+        if (seen[result.shard] != NULL) {
+            fprintf(stderr, "Ошибка: шард %d встречается дважды (%s и %s).\n", result.shard, seen[result.shard], resultPaths[i]);
+            ok = false;
+            continue;
+        }
+        if (result.tasks != expectedTasks[result.shard]) {
+            fprintf(stderr, "Ошибка: в %s посчитано %zu задач шарда %d, по плану %zu.\n",
+                    resultPaths[i], result.tasks, result.shard, expectedTasks[result.shard]);
+            ok = false;
+            continue;
+        }
+
+        seen[result.shard] = resultPaths[i];
+        solutions += result.solutions;
+        nodes += result.nodes;
+        seconds += result.seconds;
+    }
+
+    for (int sh = 0; sh < job.shards; sh++) {
+        if (seen[sh] == NULL) {
+            fprintf(stderr, "Ошибка: нет результата шарда %d.\n", sh);
+            ok = false;
+        }
+    }
+
+    if (ok) {
+        printf("Слияние: N = %d | Q = %d | шардов = %d | всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | суммарное время шардов = %.3f с\n",
+               job.N, job.Q, job.shards, solutions, nodes, seconds);
+    }
+
+    free(expectedTasks);
+    free(seen);
+    freeShardJob(&job);
+    return ok;
+}
+
+// Перебор с учетом симметрии: первая строка только в левой половине, решения приводятся к каноническому виду.
+
+// Поворот на 90 градусов: ферзь (r, c) переходит в (c, N-1-r)
+static void rotateBoard(const int *src, int *dst, int N)
+{
+    for (int r = 0; r < N; r++) {
+        dst[src[r]] = N - 1 - r;
+    }
+}
+
+// Отражение относительно вертикальной оси
+static void mirrorBoard(const int *src, int *dst, int N)
+{
+    for (int r = 0; r < N; r++) {
+        dst[r] = N - 1 - src[r];
+    }
+}
+
+static int compareBoards(const int *a, const int *b, int N)
+{
+    for (int r = 0; r < N; r++) {
+        if (a[r] != b[r]) {
+            return (a[r] < b[r]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+// Решение каноническое, если оно лексикографически не больше ни одного из 8 своих образов.
+// Каноническое решение всегда начинается в левой половине, поэтому попадает в сокращенный перебор.
+static bool isCanonical(SymmetrySearch *ss)
+{
+    int N = ss->N;
+
+    for (int r = 0; r < N; r++) {
+        ss->best[r] = ss->board[r];
+    }
+
+    for (int m = 0; m < 2; m++) {
+        if (m == 1) {
+            mirrorBoard(ss->board, ss->best, N);
+            if (compareBoards(ss->best, ss->board, N) < 0) {
+                return false;
+            }
+        }
+
+        for (int k = 0; k < 3; k++) {
+            rotateBoard(ss->best, ss->image, N);
+            if (compareBoards(ss->image, ss->board, N) < 0) {
+                return false;
+            }
+
+            for (int r = 0; r < N; r++) {
+                ss->best[r] = ss->image[r];
+            }
+        }
+    }
+
+    return true;
+}
+
+static void symmetryDFS(SymmetrySearch *ss, int row, uint32_t cols, uint32_t diag, uint32_t anti)
+{
+    ss->expandedStates++;
+
+    if (row == ss->N) {
+        ss->totalCount += ss->weight;
+
+        if (isCanonical(ss)) {
+            ss->uniqueCount++;
+            printSolutionByBoard(ss->out, ss->board, ss->N, ss->N, &ss->printed);
+        }
+        return;
+    }
+
+    uint32_t freeCols = ~(cols | diag | anti) & ss->mask;
+    while (freeCols != 0) {
+        uint32_t bit = freeCols & (0u - freeCols);
+        freeCols ^= bit;
+
+        ss->board[row] = __builtin_ctz(bit);
+        symmetryDFS(ss, row + 1, cols | bit, ((diag | bit) << 1) & ss->mask, (anti | bit) >> 1);
+    }
+}
+
+// Расстановки с ферзем первой строки в столбце c и в столбце N-1-c зеркальны, поэтому левая половина
+// считается с весом 2. При нечетном N средний столбец отражается сам в себя: там пополам делится вторая строка.
+static SymmetrySearch solveSymmetric(int N, SolutionOutput *out)
+{
+    SymmetrySearch ss;
+
+    ss.N = N;
+    ss.mask = fullMask(N);
+    ss.board = (int *)malloc((size_t)N * sizeof(int));
+    ss.image = (int *)malloc((size_t)N * sizeof(int));
+    ss.best = (int *)malloc((size_t)N * sizeof(int));
+    ss.out = out;
+    ss.printed = 0;
+    ss.uniqueCount = 0;
+    ss.totalCount = 0;
+    ss.expandedStates = 1;
+    ss.peakBytes = 3 * (size_t)N * sizeof(int);
+    ss.allocations = 3;
+
+    if (!ss.board || !ss.image || !ss.best) {
+        fprintf(stderr, "Ошибка выделения памяти для перебора с симметрией.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint32_t half = (1u << (N / 2)) - 1u;
+
+    ss.weight = 2;
+    for (uint32_t freeCols = half; freeCols != 0; freeCols &= freeCols - 1) {
+        uint32_t bit = freeCols & (0u - freeCols);
+
+        ss.board[0] = __builtin_ctz(bit);
+        symmetryDFS(&ss, 1, bit, (bit << 1) & ss.mask, bit >> 1);
+    }
+
+    if (N % 2 == 1) {
+        int middle = N / 2;
+        uint32_t bit = 1u << middle;
+
+        ss.board[0] = middle;
+
+        if (N == 1) {
+            ss.weight = 1;
+            symmetryDFS(&ss, 1, bit, (bit << 1) & ss.mask, bit >> 1);
+        } else {
+            uint32_t cols = bit;
+            uint32_t diag = (bit << 1) & ss.mask;
+            uint32_t anti = bit >> 1;
+
+            ss.expandedStates++;
+
+            // Во второй строке средний столбец занят, поэтому левая половина и правая зеркальны
+            for (uint32_t freeCols = ~(cols | diag | anti) & half; freeCols != 0; freeCols &= freeCols - 1) {
+                uint32_t next = freeCols & (0u - freeCols);
+
+                ss.board[1] = __builtin_ctz(next);
+                symmetryDFS(&ss, 2, cols | next, ((diag | next) << 1) & ss.mask, (anti | next) >> 1);
+            }
+        }
+    }
+
+    flushOutput(out);
+    free(ss.board);
+    free(ss.image);
+    free(ss.best);
+    ss.board = NULL;
+    ss.image = NULL;
+    ss.best = NULL;
+    return ss;
+}
+
+static void printSymmetryStats(const SymmetrySearch *ss)
+{
+    printf("Симметрия: уникальных решений = %" PRIu64 " | всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 "\n\n",
+           ss->uniqueCount, ss->totalCount, ss->expandedStates);
+}
+
+// Локальный поиск min-conflicts для больших N: одно решение без перебора дерева.
+// Столбцы всегда образуют перестановку, а ход - обмен столбцов двух строк, поэтому столбцы
+// не конфликтуют никогда и оценка хода сводится к четырем счетчикам диагоналей.
+
+#define MAX_LOCAL_N 50000000
+#define LOCAL_INIT_TRIES 32       // попыток найти свободную клетку строки при начальной расстановке
+#define LOCAL_SWAP_FACTOR 32      // оцененных обменов на одну строку до рестарта
+#define LOCAL_MAX_RESTARTS 64
+
+static uint64_t nextRandom(uint64_t *rng)
+{
+    uint64_t x = *rng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *rng = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+static int randomBelow(uint64_t *rng, int n)
+{
+    return (int)(nextRandom(rng) % (uint64_t)n);
+}
+
+static void placeQueen(LocalSearch *ls, int row, int col)
+{
+    if (ls->diag[row + col]++ > 0) {
+        ls->collisions++;
+    }
+    if (ls->anti[row - col + ls->N - 1]++ > 0) {
+        ls->collisions++;
+    }
+}
+
+static void liftQueen(LocalSearch *ls, int row, int col)
+{
+    if (--ls->diag[row + col] > 0) {
+        ls->collisions--;
+    }
+    if (--ls->anti[row - col + ls->N - 1] > 0) {
+        ls->collisions--;
+    }
+}
+
+static bool isAttacked(const LocalSearch *ls, int row)
+{
+    int col = ls->board[row];
+    return ls->diag[row + col] > 1 || ls->anti[row - col + ls->N - 1] > 1;
+}
+
+// Начальная расстановка: строка получает случайный из оставшихся столбцов, свободный по диагоналям.
+// Почти все строки ставятся без конфликтов, на ремонт остаются единицы в конце доски.
+static void greedyPlacement(LocalSearch *ls)
+{
+    int N = ls->N;
+
+    for (int i = 0; i < N; i++) {
+        ls->board[i] = i;
+    }
+    for (int i = 0; i < 2 * N - 1; i++) {
+        ls->diag[i] = 0;
+        ls->anti[i] = 0;
+    }
+    ls->collisions = 0;
+
+    for (int row = 0; row < N; row++) {
+        int j = row;
+
+        for (int t = 0; t < LOCAL_INIT_TRIES; t++) {
+            j = row + randomBelow(&ls->rng, N - row);
+            int col = ls->board[j];
+            if (ls->diag[row + col] == 0 && ls->anti[row - col + N - 1] == 0) {
+                break;
+            }
+        }
+
+        int tmp = ls->board[row];
+        ls->board[row] = ls->board[j];
+        ls->board[j] = tmp;
+        placeQueen(ls, row, ls->board[row]);
+    }
+}
+
+// Обмен столбцов строк a и b принимается, только если число конфликтов строго уменьшилось
+static bool trySwap(LocalSearch *ls, int a, int b)
+{
+    int colA = ls->board[a];
+    int colB = ls->board[b];
+    int64_t before = ls->collisions;
+
+    ls->evaluations++;
+
+    liftQueen(ls, a, colA);
+    liftQueen(ls, b, colB);
+    placeQueen(ls, a, colB);
+    placeQueen(ls, b, colA);
+
+    if (ls->collisions < before) {
+        ls->board[a] = colB;
+        ls->board[b] = colA;
+        ls->swaps++;
+        return true;
+    }
+
+    liftQueen(ls, a, colB);
+    liftQueen(ls, b, colA);
+    placeQueen(ls, a, colA);
+    placeQueen(ls, b, colB);
+    return false;
+}
+
+// Ремонт: атакованные строки меняются со случайными, пока конфликты не исчезнут или не кончится бюджет
+static bool repairPlacement(LocalSearch *ls, int *attacked)
+{
+    int N = ls->N;
+    uint64_t budget = ls->evaluations + (uint64_t)LOCAL_SWAP_FACTOR * (uint64_t)N;
+
+    while (ls->collisions > 0) {
+        int count = 0;
+        for (int row = 0; row < N; row++) {
+            if (isAttacked(ls, row)) {
+                attacked[count++] = row;
+            }
+        }
+
+        for (int k = 0; k < count; k++) {
+            int row = attacked[k];
+
+            while (isAttacked(ls, row)) {
+                if (ls->evaluations >= budget) {
+                    return false;
+                }
+
+                int other = randomBelow(&ls->rng, N);
+                if (other != row) {
+                    trySwap(ls, row, other);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static LocalSearch solveMinConflicts(int N, SolutionOutput *out)
+{
+    LocalSearch ls;
+    double start = nowSeconds();
+
+    ls.N = N;
+    ls.board = (int *)allocOrDie((size_t)N * sizeof(int));
+    ls.diag = (int *)allocOrDie((size_t)(2 * N - 1) * sizeof(int));
+    ls.anti = (int *)allocOrDie((size_t)(2 * N - 1) * sizeof(int));
+    ls.rng = 0x9E3779B97F4A7C15ULL ^ (uint64_t)N;
+    ls.swaps = 0;
+    ls.evaluations = 0;
+    ls.restarts = 0;
+    ls.solved = false;
+
+    int *attacked = (int *)allocOrDie((size_t)N * sizeof(int));
+
+    // Для N = 2 и N = 3 решений нет: поиск останавливается по числу рестартов
+    for (;;) {
+        greedyPlacement(&ls);
+        if (repairPlacement(&ls, attacked)) {
+            ls.solved = true;
+            break;
+        }
+        if (ls.restarts == LOCAL_MAX_RESTARTS) {
+            break;
+        }
+        ls.restarts++;
+    }
+
+    ls.seconds = nowSeconds() - start;
+
+    // Полная доска печатается только для небольших N; компактная строка - для любого
+    if (ls.solved && (out->mode == OUTPUT_COMPACT || (out->mode == OUTPUT_FULL && N <= MAX_N))) {
+        uint64_t printed = 0;
+        printSolutionByBoard(out, ls.board, N, N, &printed);
+        flushOutput(out);
+    }
+
+    free(attacked);
+    free(ls.diag);
+    free(ls.anti);
+    ls.diag = NULL;
+    ls.anti = NULL;
+    return ls;
+}
+
+static void freeLocalSearch(LocalSearch *ls)
+{
+    free(ls->board);
+    ls->board = NULL;
+}
+
+static void printLocalSearchStats(const LocalSearch *ls)
+{
+    if (ls->solved) {
+        printf("Min-conflicts: решение найдено | N = %d | обменов = %" PRIu64 " | оценено обменов = %" PRIu64 " | рестартов = %d | время = %.3f с\n\n",
+               ls->N, ls->swaps, ls->evaluations, ls->restarts, ls->seconds);
+    } else {
+        printf("Min-conflicts: решение не найдено за %d рестартов | N = %d | оценено обменов = %" PRIu64 " | время = %.3f с\n\n",
+               ls->restarts, ls->N, ls->evaluations, ls->seconds);
+    }
+}
+
+// Подсчет с мемоизацией. Расстановка Q ферзей в первых Q строках - это полоса Q x N, которую
+// удобнее проходить по столбцам: в каждом столбце не больше одного ферзя, сигнатура поддерева -
+// (столбец, занятые строки полосы, маски диагоналей) шириной Q бит. При Q < N одинаковые
+// сигнатуры встречаются постоянно, и поддерево считается один раз. Таблица фиксированного
+// размера: при заполнении корзины вытесняется запись самого мелкого поддерева.
+
+#define MEMO_BUCKET 4
+#define DEFAULT_MEMO_MB 64
+
+static uint64_t memoHash(int column, uint32_t rows, uint32_t diag, uint32_t anti)
+{
+    uint64_t h = ((uint64_t)rows << 32) ^ diag;
+    h ^= ((uint64_t)anti << 17) ^ ((uint64_t)column << 56);
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static MemoEntry *memoBucket(const MemoSearch *ms, int column, uint32_t rows, uint32_t diag, uint32_t anti)
+{
+    size_t index = (size_t)memoHash(column, rows, diag, anti) & (ms->capacity - 1);
+    return &ms->table[index & ~(size_t)(MEMO_BUCKET - 1)];
+}
+
+static bool memoLookup(MemoSearch *ms, int column, uint32_t rows, uint32_t diag, uint32_t anti, BigCount *count)
+{
+    MemoEntry *bucket = memoBucket(ms, column, rows, diag, anti);
+
+    for (int i = 0; i < MEMO_BUCKET; i++) {
+        MemoEntry *e = &bucket[i];
+        if (e->column == column && e->rows == rows && e->diag == diag && e->anti == anti) {
+            *count = e->count;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void memoStore(MemoSearch *ms, int column, uint32_t rows, uint32_t diag, uint32_t anti, BigCount count)
+{
+    MemoEntry *bucket = memoBucket(ms, column, rows, diag, anti);
+    MemoEntry *victim = NULL;
+
+    for (int i = 0; i < MEMO_BUCKET; i++) {
+        MemoEntry *e = &bucket[i];
+        if (e->column < 0) {
+            victim = e;
+            ms->used++;
+            break;
+        }
+        // Чем правее столбец, тем дешевле пересчитать поддерево
+        if (victim == NULL || e->column > victim->column) {
+            victim = e;
+        }
+    }
+
+    if (victim->column >= 0) {
+        if (victim->column < column) {
+            return;
+        }
+        ms->replaced++;
+    }
+
+    victim->rows = rows;
+    victim->diag = diag;
+    victim->anti = anti;
+    victim->column = column;
+    victim->count = count;
+}
+
+// Отражение Q младших битов: строка r переходит в Q-1-r
+static uint32_t mirrorMask(uint32_t x, int Q)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+    x = __builtin_bswap32(x);
+    return x >> (32 - Q);
+}
+
+// Приведение сигнатуры. Диагональ, идущая вниз, дальше бьет только строки ниже своей, поэтому
+// бит лишний, если ниже него свободных строк нет; для диагонали вверх - наоборот.
+// Из пары сигнатур, зеркальных относительно середины полосы, берется меньшая.
+static void normalizeSignature(const MemoSearch *ms, uint32_t rows, uint32_t *diag, uint32_t *anti, uint32_t key[3])
+{
+    uint32_t freeRows = ~rows & ms->mask;
+    int lowest = __builtin_ctz(freeRows);
+    int highest = 31 - __builtin_clz(freeRows);
+
+    *diag &= (highest >= 31) ? UINT32_MAX : ((2u << highest) - 1u);
+    *anti &= ~((1u << lowest) - 1u);
+
+    uint32_t mRows = mirrorMask(rows, ms->Q);
+    uint32_t mDiag = mirrorMask(*anti, ms->Q);
+    uint32_t mAnti = mirrorMask(*diag, ms->Q);
+
+    bool mirrored = mRows < rows || (mRows == rows && (mDiag < *diag || (mDiag == *diag && mAnti < *anti)));
+    key[0] = mirrored ? mRows : rows;
+    key[1] = mirrored ? mDiag : *diag;
+    key[2] = mirrored ? mAnti : *anti;
+}
+
+// Число способов достроить полосу начиная со столбца column: столбец пропускается либо получает
+// ферзя в одной из свободных, не битых по диагоналям строк
+static BigCount memoCount(MemoSearch *ms, int column, uint32_t rows, uint32_t diag, uint32_t anti)
+{
+    ms->visitedStates++;
+
+    int left = ms->Q - __builtin_popcount(rows);
+    if (left == 0) {
+        return 1;
+    }
+    if (ms->N - column < left) {
+        return 0;
+    }
+
+    uint32_t key[3];
+    normalizeSignature(ms, rows, &diag, &anti, key);
+
+    BigCount count = 0;
+    if (memoLookup(ms, column, key[0], key[1], key[2], &count)) {
+        ms->hits++;
+        return count;
+    }
+
+    count = memoCount(ms, column + 1, rows, (diag << 1) & ms->mask, anti >> 1);
+
+    uint32_t freeRows = ~(rows | diag | anti) & ms->mask;
+    while (freeRows != 0) {
+        uint32_t bit = freeRows & (0u - freeRows);
+        freeRows ^= bit;
+        count += memoCount(ms, column + 1, rows | bit, ((diag | bit) << 1) & ms->mask, (anti | bit) >> 1);
+    }
+
+    memoStore(ms, column, key[0], key[1], key[2], count);
+    return count;
+}
+
+static MemoSearch solveMemoCount(int N, int Q, int memoMegabytes)
+{
+    MemoSearch ms;
+    double start = nowSeconds();
+
+    ms.N = N;
+    ms.Q = Q;
+    ms.mask = fullMask(Q);
+    ms.used = 0;
+    ms.visitedStates = 0;
+    ms.hits = 0;
+    ms.replaced = 0;
+
+    // Наибольшая степень двойки записей, укладывающаяся в бюджет
+    size_t budget = (size_t)memoMegabytes * 1024 * 1024;
+    ms.capacity = MEMO_BUCKET;
+    while (ms.capacity * 2 * sizeof(MemoEntry) <= budget) {
+        ms.capacity *= 2;
+    }
+
+    ms.table = (MemoEntry *)allocOrDie(ms.capacity * sizeof(MemoEntry));
+    for (size_t i = 0; i < ms.capacity; i++) {
+        ms.table[i].column = -1;
+    }
+
+    ms.solutionCount = memoCount(&ms, 0, 0, 0, 0);
+    ms.seconds = nowSeconds() - start;
+
+    free(ms.table);
+    ms.table = NULL;
+    return ms;
+}
+
+// Десятичная запись 128-битного числа
+static const char *formatBigCount(BigCount value, char *buf, size_t size)
+{
+    char *p = buf + size - 1;
+    *p = '\0';
+
+    do {
+        *--p = (char)('0' + (int)(value % 10));
+        value /= 10;
+    } while (value != 0 && p > buf);
+
+    return p;
+}
+
+static void printMemoStats(const MemoSearch *ms)
+{
+    char buf[48];
+
+    printf("Мемоизация: всего решений = %s | посещено состояний = %" PRIu64 " | попаданий в таблицу = %" PRIu64 "\n",
+           formatBigCount(ms->solutionCount, buf, sizeof(buf)), ms->visitedStates, ms->hits);
+    printf("Мемоизация: записей = %zu из %zu (%zu КБ) | вытеснено = %" PRIu64 " | время = %.3f с\n\n",
+           ms->used, ms->capacity, ms->capacity * sizeof(MemoEntry) / 1024, ms->replaced, ms->seconds);
+}
+
+// Задача о ферзях как точное покрытие для Dancing Links (dlx.c).
+// Элементы: строки 0..Q-1 (основные), столбцы (основные при Q = N, иначе вторичные),
+// диагонали обоих направлений (вторичные, по желанию). Опция r * N + c - ферзь в клетке (r, c).
+
+typedef struct {
+    int N;
+    int Q;
+    int *board;
+    SolutionOutput *out;
+    uint64_t printed;
+} QueensCover;
+
+typedef struct {
+    DlxStats dlx;
+    size_t bytes;
+    double seconds;
+} CoverStats;
+
+static Dlx *buildQueensCover(int N, int Q, bool diagonals)
+{
+    int columnBase = Q;
+    int diagBase = columnBase + N;
+    int antiBase = diagBase + 2 * N - 1;
+    int primary = (Q == N) ? Q + N : Q;
+    int secondary = (Q == N ? 0 : N) + (diagonals ? 2 * (2 * N - 1) : 0);
+
+    Dlx *dlx = dlxCreate(primary, secondary);
+
+    for (int r = 0; r < Q; r++) {
+        for (int c = 0; c < N; c++) {
+            int items[4];
+            int count = 0;
+
+            items[count++] = r;
+            items[count++] = columnBase + c;
+            if (diagonals) {
+                items[count++] = diagBase + r + c;
+                items[count++] = antiBase + r - c + N - 1;
+            }
+
+            dlxAddOption(dlx, items, count);
+        }
+    }
+
+    return dlx;
+}
+
+// Опции решения приходят в порядке выбора (по эвристике MRV), доска собирается по строкам
+static void onQueensCover(const int *options, int count, void *ctx)
+{
+    QueensCover *qc = (QueensCover *)ctx;
+
+    for (int k = 0; k < count; k++) {
+        qc->board[options[k] / qc->N] = options[k] % qc->N;
+    }
+
+    // При Q < N опции покрывают только строки 0..Q-1; остальные строки доски должны остаться пустыми
+    for (int r = qc->Q; r < qc->N; r++) {
+        if (qc->board[r] != -1) {
+            fprintf(stderr, "Ошибка: решение DLX ставит ферзя в строку %d при Q = %d.\n", r + 1, qc->Q);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    printSolutionByBoard(qc->out, qc->board, qc->Q, qc->N, &qc->printed);
+}
+
+static CoverStats solveQueensCover(int N, int Q, bool diagonals, bool firstOnly, SolutionOutput *out)
+{
+    CoverStats stats;
+    double start = nowSeconds();
+
+    QueensCover qc;
+    qc.N = N;
+    qc.Q = Q;
+    qc.board = (int *)allocOrDie((size_t)N * sizeof(int));
+    qc.out = out;
+
+    // Строки без ферзей при Q < N
+    for (int r = 0; r < N; r++) {
+        qc.board[r] = -1;
+    }
+    qc.printed = 0;
+
+    Dlx *dlx = buildQueensCover(N, Q, diagonals);
+
+    DlxMode mode = firstOnly ? DLX_FIRST : (out->mode == OUTPUT_COUNT ? DLX_COUNT : DLX_ENUMERATE);
+    stats.dlx = dlxSolve(dlx, mode, onQueensCover, &qc);
+    stats.bytes = dlxBytes(dlx);
+    stats.seconds = nowSeconds() - start;
+
+    flushOutput(out);
+    dlxFree(dlx);
+    free(qc.board);
+    return stats;
+}
+
+static void printCoverStats(const char *methodName, const CoverStats *stats)
+{
+    printf("%s: всего решений = %" PRIu64 " | вершин поиска = %" PRIu64 " | обновлений ссылок = %" PRIu64 "\n",
+           methodName, stats->dlx.solutionCount, stats->dlx.searchNodes, stats->dlx.updates);
+    printf("%s: память узлов = %zu КБ | время = %.3f с\n\n", methodName, stats->bytes / 1024, stats->seconds);
+}
+
+// Подсчет одной и той же задачи двумя движками: DLX и битовым DFS в один поток
+static void benchmarkCover(int N, int Q)
+{
+    SolutionOutput countOnly;
+    initOutput(&countOnly, OUTPUT_COUNT);
+
+    CoverStats cover = solveQueensCover(N, Q, true, false, &countOnly);
+    printCoverStats("DLX", &cover);
+
+    ParallelStats dfs = solveParallel(N, Q, 1, NULL, &countOnly);
+    printf("Битовый DFS: всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | время = %.3f с\n\n",
+           dfs.solutionCount, dfs.expandedStates, dfs.seconds);
+
+    if (cover.dlx.solutionCount != dfs.solutionCount) {
+        printf("Внимание: число решений DLX и DFS не совпадает!\n\n");
+    }
+    if (dfs.seconds > 0.0) {
+        printf("Отношение времени DLX / битовый DFS = %.2f\n\n", cover.seconds / dfs.seconds);
+    }
+
+    freeOutput(&countOnly);
+}
+
+// Достроение частичной расстановки, заданной пользователем (queens_complete.c)
+
+typedef struct {
+    SolutionOutput *out;
+    int N;
+    int Q;
+    uint64_t printed;
+} CompletionPrinter;
+
+static int printCompletion(const int *board, void *ctx)
+{
+    CompletionPrinter *printer = (CompletionPrinter *)ctx;
+    printSolutionByBoard(printer->out, board, printer->Q, printer->N, &printer->printed);
+    return 1;
+}
+
+// Доска в виде столбцов по строкам через запятую: 1..N - столбец ферзя, 0 или "." - пустая строка.
+// Недостающие строки в конце считаются пустыми. Ошибка сообщается с номером поля и причиной.
+static bool parseBoardSpec(const char *text, int N, int *board)
+{
+    int row = 0;
+
+    for (int r = 0; r < N; r++) {
+        board[r] = -1;
+    }
+
+    if (*text == '\0') {
+        return true;
+    }
+
+    while (1) {
+        const char *comma = strchr(text, ',');
+        size_t len = comma != NULL ? (size_t)(comma - text) : strlen(text);
+        int field = row + 1;
+
+        if (len == 0) {
+            fprintf(stderr, "Некорректная доска: поле %d пустое\n", field);
+            return false;
+        }
+        if (row >= N) {
+            fprintf(stderr, "Некорректная доска: полей больше, чем строк на доске (N = %d)\n", N);
+            return false;
+        }
+
+        if (len != 1 || *text != '.') {
+            char *end;
+            long col = strtol(text, &end, 10);
+            if (end != text + len) {
+                fprintf(stderr, "Некорректная доска: поле %d (\"%.*s\") не является номером столбца\n", field, (int)len, text);
+                return false;
+            }
+            if (col < 0 || col > N) {
+                fprintf(stderr, "Некорректная доска: в поле %d столбец %ld вне диапазона 0..%d\n", field, col, N);
+                return false;
+            }
+            board[row] = (int)col - 1;
+        }
+        row++;
+
+        if (comma == NULL) {
+            return true;
+        }
+        text = comma + 1;
+    }
+}
+
+static void solveCompletion(int N, int Q, const int *board, bool firstOnly, SolutionOutput *out)
+{
+    const char *error = queens_complete_check(N, Q, board);
+    if (error != NULL) {
+        printf("Ошибка: %s.\n\n", error);
+        return;
+    }
+
+    int given = 0;
+    for (int r = 0; r < N; r++) {
+        given += board[r] != -1;
+    }
+
+    CompletionPrinter printer = {out, N, Q, 0};
+    QueensCompleteStats stats;
+    double start = nowSeconds();
+
+    queens_complete_run(N, Q, board, firstOnly ? 1 : 0, out->mode == OUTPUT_COUNT ? NULL : printCompletion, &printer, &stats);
+
+    double elapsed = nowSeconds() - start;
+    flushOutput(out);
+
+    if (stats.solutions == 0) {
+        printf("Достроение: для данной расстановки решений нет.\n\n");
+    }
+    printf("Достроение: дано ферзей = %d | найдено решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | время = %.3f мс\n\n",
+           given, stats.solutions, stats.nodes, elapsed * 1000.0);
+}
+
+// Сравнение ядер подсчета поддеревьев на одних и тех же задачах-префиксах (один поток)
+#define KERNEL_TASKS 4096
+
+static SubtreeCount timeKernel(SubtreeKernel kernel, const BoardMasks *masks, size_t count, int depth, int Q, int N, double *seconds)
+{
+    double start = nowSeconds();
+    SubtreeCount result = kernel(masks, count, depth, Q, N);
+    *seconds = nowSeconds() - start;
+    return result;
+}
+
+static void benchmarkKernels(int N, int Q)
+{
+    ParallelContext ctx = {0};
+    PrefixTask *tasks;
+    uint8_t *prefixCols;
+    uint64_t prefixNodes;
+    const char *selected;
+
+    ctx.N = N;
+    ctx.Q = Q;
+    ctx.mask = fullMask(N);
+    size_t count = buildPrefixTasks(&ctx, KERNEL_TASKS, &tasks, &prefixCols, &prefixNodes);
+
+    BoardMasks *masks = (BoardMasks *)allocOrDie(count * sizeof(BoardMasks));
+    for (size_t t = 0; t < count; t++) {
+        masks[t].cols = tasks[t].cols;
+        masks[t].diag = tasks[t].diag;
+        masks[t].anti = tasks[t].anti;
+    }
+
+    SubtreeKernel kernel = kernelSelect(&selected);
+    printf("Задач = %zu (префикс %d строк) | выбрано ядро: %s\n\n", count, ctx.prefixDepth, selected);
+
+    double scalarSeconds;
+    SubtreeCount scalar = timeKernel(kernelCountScalar, masks, count, ctx.prefixDepth, Q, N, &scalarSeconds);
+    printf("Скалярное ядро: всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | время = %.3f с\n",
+           scalar.solutions, prefixNodes + scalar.nodes, scalarSeconds);
+
+    // Сравнивать есть с чем, только если выбрано не скалярное ядро
+    if (kernel == kernelCountScalar) {
+        printf("Процессор не поддерживает AVX2: векторное ядро не запускалось.\n\n");
+    } else {
+        double vectorSeconds;
+        SubtreeCount vector = timeKernel(kernel, masks, count, ctx.prefixDepth, Q, N, &vectorSeconds);
+        printf("Ядро %s: всего решений = %" PRIu64 " | раскрыто состояний = %" PRIu64 " | время = %.3f с\n\n",
+               selected, vector.solutions, prefixNodes + vector.nodes, vectorSeconds);
+
+        if (vector.solutions != scalar.solutions || vector.nodes != scalar.nodes) {
+            printf("Внимание: результаты ядер не совпадают!\n\n");
+        }
+        if (vectorSeconds > 0.0) {
+            printf("Отношение времени скалярное / выбранное = %.2f\n\n", scalarSeconds / vectorSeconds);
+        }
+    }
+
+    free(masks);
+    free(tasks);
+    free(prefixCols);
+}
+
+// Пользовательский ввод и сравнение.
+
+static int readInt(const char *prompt, int lo, int hi)
+{
+    int v;
+    int rc;
+
+    while (1) {
+        printf("%s", prompt);
+        rc = scanf("%d", &v);
+
+        if (rc == 1 && v >= lo && v <= hi) {
+            return v;
+        }
+
+        printf("Ошибка: введите число от %d до %d.\n", lo, hi);
+
+        while (getchar() != '\n') {
+        }
+    }
+}
+
+// При равном числе шагов выигрывает метод, стоящий в списке раньше
+static const char *bestBySteps(const SearchStats *bfsStats, const SearchStats *bfsCompactStats, const SearchStats *dfsIterStats, const SearchStats *dfsRecStats, const SearchStats *dfsPathStats)
+{
+    const char *bestName = NULL;
+    uint64_t bestSteps = 0;
+
+    const char *names[5] = {"BFS", "BFS компактный", "DFS итерационный", "DFS рекурсивный", "DFS рекурсивный с Path"};
+    const SearchStats *stats[5] = {bfsStats, bfsCompactStats, dfsIterStats, dfsRecStats, dfsPathStats};
+
+    for (int i = 0; i < 5; i++) {
+        if (stats[i] == NULL || stats[i]->stepsToFirstSolution == NO_SOLUTION_STEP) {
+            continue;
+        }
+
+        if (bestName == NULL || stats[i]->stepsToFirstSolution < bestSteps) {
+            bestName = names[i];
+            bestSteps = stats[i]->stepsToFirstSolution;
+        }
+    }
+
+    return bestName;
+}
+
+static void printBestSummary(const SearchStats *bfsStats, const SearchStats *bfsCompactStats, const SearchStats *dfsIterStats, const SearchStats *dfsRecStats, const SearchStats *dfsPathStats)
+{
+    const char *bestName = bestBySteps(bfsStats, bfsCompactStats, dfsIterStats, dfsRecStats, dfsPathStats);
+
+    printf("=== Сравнение методов по числу шагов до первого решения ===\n");
+    if (bestName != NULL) {
+        printf("Лучший метод: %s\n\n", bestName);
+    } else {
+        printf("Лучший метод: не определен, решений не найдено.\n\n");
+    }
+}
+
+static void printNoSolutionIfNeeded(const char *methodName, int N, int Q, const SearchStats *stats)
+{
+    if (stats->solutionCount == 0) {
+        printf("%s: для N=%d, Q=%d решений не найдено.\n\n", methodName, N, Q);
+    }
+}
+
+#define MAX_THREADS 256
+#define MAX_MEMO_MB 16384
+
+static void readInteractiveConfig(RunConfig *cfg)
+{
+    printf("=== Задача о N ферзях ===\n");
+    printf("Поиск решения в неявном графе пространства состояний\n\n");
+
+    cfg->N = readInt("Введите размерность доски N (1..12): ", 1, 12);
+    cfg->Q = readInt("Введите число ферзей Q (1..N):       ", 1, cfg->N);
+
+    printf("\nВыберите метод поиска:\n");
+    printf("1 - Поиск в ширину (BFS)\n");
+    printf("2 - Поиск в глубину, итерационный (DFS)\n");
+    printf("3 - Поиск в глубину, рекурсивный\n");
+    printf("4 - Поиск в глубину, рекурсивный с Path\n");
+    printf("5 - Выполнить все методы и сравнить\n");
+    printf("6 - Поиск в ширину (BFS) с компактным хранением слоев\n");
+    printf("7 - Параллельный подсчет решений (DFS по префиксам)\n");
+    printf("8 - Перебор с учетом симметрии доски (только Q = N)\n");
+    printf("9 - Локальный поиск min-conflicts (одно решение, Q = N)\n");
+    printf("10 - Подсчет решений с мемоизацией поддеревьев\n");
+    printf("11 - Точное покрытие (Dancing Links)\n");
+    printf("12 - Сравнение Dancing Links с битовым DFS\n");
+    printf("13 - Параллельный поиск в ширину (BFS по слоям)\n");
+    printf("14 - Сравнение векторного (AVX2) и скалярного ядер подсчета\n");
+    printf("15 - Достроение частичной расстановки\n\n");
+
+    cfg->method = (SearchMethod)readInt("Ваш выбор (1..15): ", 1, 15);
+
+    cfg->maxDepth = cfg->Q;
+    if (cfg->method == METHOD_DFS_ITER || cfg->method == METHOD_DFS_REC || cfg->method == METHOD_DFS_REC_PATH || cfg->method == METHOD_ALL) {
+        printf("\nДля DFS используется ограниченный перебор в глубину.\n");
+        cfg->maxDepth = readInt("Введите максимальную глубину просмотра (1..Q): ", 1, cfg->Q);
+    }
+
+    printf("\nРежим вывода решений:\n");
+    printf("1 - Операторы и доска\n");
+    printf("2 - Одна строка на решение\n");
+    printf("3 - Только подсчет\n\n");
+
+    cfg->output = (OutputMode)readInt("Ваш выбор (1..3): ", 1, 3);
+
+    cfg->threads = 1;
+    cfg->memoMegabytes = DEFAULT_MEMO_MB;
+    cfg->diagonals = true;
+    cfg->firstOnly = false;
+    cfg->checkpoint.path = NULL;
+    cfg->checkpoint.resume = false;
+    cfg->checkpoint.intervalSeconds = DEFAULT_CHECKPOINT_INTERVAL;
+    if (cfg->method == METHOD_PARALLEL || cfg->method == METHOD_BFS_PARALLEL) {
+        cfg->threads = readInt("Число потоков (1..256): ", 1, MAX_THREADS);
+    }
+
+    cfg->boardSpec = NULL;
+    for (int r = 0; r < cfg->N; r++) {
+        cfg->board[r] = -1;
+    }
+    if (cfg->method == METHOD_COMPLETE) {
+        char prompt[64];
+
+        printf("\nВведите столбцы уже поставленных ферзей по строкам (0 - строка пуста).\n");
+        for (int r = 0; r < cfg->Q; r++) {
+            snprintf(prompt, sizeof(prompt), "Строка %d (0..%d): ", r + 1, cfg->N);
+            cfg->board[r] = readInt(prompt, 0, cfg->N) - 1;
+        }
+        cfg->firstOnly = readInt("Показать: 1 - все достроения, 2 - только первое: ", 1, 2) == 2;
+    }
+}
+
+static bool parseInt(const char *text, int *value)
+{
+    char *end;
+    long parsed;
+
+    errno = 0;
+    parsed = strtol(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || parsed < 0 || parsed > 1000000000L) {
+        return false;
+    }
+
+    *value = (int)parsed;
+    return true;
+}
+
+static SearchMethod parseMethod(const char *text)
+{
+    if (strcmp(text, "bfs") == 0) return METHOD_BFS;
+    if (strcmp(text, "dfs_iter") == 0) return METHOD_DFS_ITER;
+    if (strcmp(text, "dfs_rec") == 0) return METHOD_DFS_REC;
+    if (strcmp(text, "dfs_rec_path") == 0) return METHOD_DFS_REC_PATH;
+    if (strcmp(text, "all") == 0) return METHOD_ALL;
+    if (strcmp(text, "bfs_compact") == 0) return METHOD_BFS_COMPACT;
+    if (strcmp(text, "bfs_parallel") == 0) return METHOD_BFS_PARALLEL;
+    if (strcmp(text, "parallel") == 0) return METHOD_PARALLEL;
+    if (strcmp(text, "symmetry") == 0) return METHOD_SYMMETRY;
+    if (strcmp(text, "min_conflicts") == 0) return METHOD_MIN_CONFLICTS;
+    if (strcmp(text, "memo_count") == 0) return METHOD_MEMO_COUNT;
+    if (strcmp(text, "dlx") == 0) return METHOD_DLX;
+    if (strcmp(text, "dlx_bench") == 0) return METHOD_DLX_BENCH;
+    if (strcmp(text, "kernel_bench") == 0) return METHOD_KERNEL_BENCH;
+    if (strcmp(text, "complete") == 0) return METHOD_COMPLETE;
+    return METHOD_UNKNOWN;
+}
+
+static OutputMode parseOutputMode(const char *text)
+{
+    if (strcmp(text, "full") == 0) return OUTPUT_FULL;
+    if (strcmp(text, "compact") == 0) return OUTPUT_COMPACT;
+    if (strcmp(text, "count") == 0) return OUTPUT_COUNT;
+    return (OutputMode)0;
+}
+
+static void printUsage(const char *prog)
+{
+    fprintf(stderr, "Использование: %s [--n N] [--q Q] [--method M] [--max-depth D] [--threads T] [--memo-mb MB]\n", prog);
+    fprintf(stderr, "          [--diagonals on|off] [--first] [--board B] [--checkpoint FILE [--checkpoint-interval S] [--resume]] [--output O]\n");
+    fprintf(stderr, "       %s plan --n N [--q Q] --shards K --job FILE\n", prog);
+    fprintf(stderr, "       %s run-shard --job FILE --shard I [--threads T] --result FILE\n", prog);
+    fprintf(stderr, "       %s merge --job FILE RESULT...\n", prog);
+    fprintf(stderr, "       %s bench [--n A[-B]] [--q A[-B]] [--max-depth A[-B]] [--methods M,...] [--repeat R] [--threads T] [--memo-mb MB]\n", prog);
+    fprintf(stderr, "Без аргументов запускается интерактивное меню.\n");
+    fprintf(stderr, "  --n N          размерность доски (1..%d, для min_conflicts 1..%d)\n", MAX_N, MAX_LOCAL_N);
+    fprintf(stderr, "  --q Q          число ферзей (1..N), по умолчанию N\n");
+    fprintf(stderr, "  --method M     bfs | bfs_compact | bfs_parallel | dfs_iter | dfs_rec | dfs_rec_path | all | parallel | symmetry\n");
+    fprintf(stderr, "                 | min_conflicts | memo_count | dlx | dlx_bench | kernel_bench | complete\n");
+    fprintf(stderr, "  --max-depth D  глубина для DFS (1..Q), по умолчанию Q\n");
+    fprintf(stderr, "  --threads T    потоки для parallel и bfs_parallel (1..%d), по умолчанию число ядер\n", MAX_THREADS);
+    fprintf(stderr, "  --memo-mb MB   память таблицы для memo_count (1..%d МБ), по умолчанию %d\n", MAX_MEMO_MB, DEFAULT_MEMO_MB);
+    fprintf(stderr, "  --diagonals    для dlx: учитывать диагонали (on) или решать задачу о ладьях (off)\n");
+    fprintf(stderr, "  --first        для dlx и complete: остановиться на первом решении\n");
+    fprintf(stderr, "  --board B      для complete: столбцы ферзей по строкам через запятую (1..N, 0 или . - пусто)\n");
+    fprintf(stderr, "  --checkpoint FILE  для parallel с --output count: периодически сохранять ход подсчета\n");
+    fprintf(stderr, "  --checkpoint-interval S  интервал записи в секундах, по умолчанию %d\n", DEFAULT_CHECKPOINT_INTERVAL);
+    fprintf(stderr, "  --resume       продолжить подсчет с контрольной точки FILE\n");
+    fprintf(stderr, "  --output O     full | compact | count, по умолчанию full\n");
+}
+
+// Разбор командной строки; false - ошибка, сообщение уже выведено
+static bool parseArgs(int argc, char *argv[], RunConfig *cfg)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    cfg->N = 0;
+    cfg->Q = 0;
+    cfg->method = METHOD_DFS_REC;
+    cfg->maxDepth = 0;
+    cfg->threads = (cpus > 0 && cpus <= MAX_THREADS) ? (int)cpus : 1;
+    cfg->memoMegabytes = DEFAULT_MEMO_MB;
+    cfg->diagonals = true;
+    cfg->firstOnly = false;
+    cfg->checkpoint.path = NULL;
+    cfg->checkpoint.resume = false;
+    cfg->checkpoint.intervalSeconds = DEFAULT_CHECKPOINT_INTERVAL;
+    cfg->boardSpec = NULL;
+    cfg->output = OUTPUT_FULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+
+        if (strcmp(opt, "--help") == 0 || strcmp(opt, "-h") == 0) {
+            printUsage(argv[0]);
+            return false;
+        }
+
+        if (strcmp(opt, "--first") == 0) {
+            cfg->firstOnly = true;
+            continue;
+        }
+        if (strcmp(opt, "--resume") == 0) {
+            cfg->checkpoint.resume = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Не указано значение параметра %s\n", opt);
+            printUsage(argv[0]);
+            return false;
+        }
+
+        const char *value = argv[++i];
+        bool ok = true;
+
+        if (strcmp(opt, "--n") == 0) {
+            ok = parseInt(value, &cfg->N);
+        } else if (strcmp(opt, "--q") == 0) {
+            ok = parseInt(value, &cfg->Q);
+        } else if (strcmp(opt, "--max-depth") == 0) {
+            ok = parseInt(value, &cfg->maxDepth);
+        } else if (strcmp(opt, "--threads") == 0) {
+            ok = parseInt(value, &cfg->threads);
+        } else if (strcmp(opt, "--memo-mb") == 0) {
+            ok = parseInt(value, &cfg->memoMegabytes);
+        } else if (strcmp(opt, "--board") == 0) {
+            cfg->boardSpec = value;
+        } else if (strcmp(opt, "--checkpoint") == 0) {
+            cfg->checkpoint.path = value;
+        } else if (strcmp(opt, "--checkpoint-interval") == 0) {
+            ok = parseInt(value, &cfg->checkpoint.intervalSeconds) && cfg->checkpoint.intervalSeconds >= 1;
+        } else if (strcmp(opt, "--diagonals") == 0) {
+            ok = strcmp(value, "on") == 0 || strcmp(value, "off") == 0;
+            cfg->diagonals = strcmp(value, "on") == 0;
+        } else if (strcmp(opt, "--method") == 0) {
+            cfg->method = parseMethod(value);
+            ok = cfg->method != METHOD_UNKNOWN;
+        } else if (strcmp(opt, "--output") == 0) {
+            cfg->output = parseOutputMode(value);
+            ok = cfg->output != 0;
+        } else {
+            fprintf(stderr, "Неизвестный параметр: %s\n", opt);
+            printUsage(argv[0]);
+            return false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Некорректное значение параметра %s: %s\n", opt, value);
+            return false;
+        }
+    }
+
+    if (cfg->Q == 0) {
+        cfg->Q = cfg->N;
+    }
+    if (cfg->maxDepth == 0) {
+        cfg->maxDepth = cfg->Q;
+    }
+
+    int maxN = (cfg->method == METHOD_MIN_CONFLICTS) ? MAX_LOCAL_N : MAX_N;
+    if (cfg->N < 1 || cfg->N > maxN) {
+        fprintf(stderr, "Размерность доски должна быть в диапазоне 1..%d\n", maxN);
+        return false;
+    }
+    if (cfg->Q < 1 || cfg->Q > cfg->N) {
+        fprintf(stderr, "Число ферзей должно быть в диапазоне 1..N\n");
+        return false;
+    }
+    if (cfg->maxDepth < 1 || cfg->maxDepth > cfg->Q) {
+        fprintf(stderr, "Глубина просмотра должна быть в диапазоне 1..Q\n");
+        return false;
+    }
+    if (cfg->threads < 1 || cfg->threads > MAX_THREADS) {
+        fprintf(stderr, "Число потоков должно быть в диапазоне 1..%d\n", MAX_THREADS);
+        return false;
+    }
+    if (cfg->memoMegabytes < 1 || cfg->memoMegabytes > MAX_MEMO_MB) {
+        fprintf(stderr, "Память таблицы должна быть в диапазоне 1..%d МБ\n", MAX_MEMO_MB);
+        return false;
+    }
+    if (cfg->checkpoint.resume && cfg->checkpoint.path == NULL) {
+        fprintf(stderr, "Для --resume нужно указать файл --checkpoint\n");
+        return false;
+    }
+    if (cfg->boardSpec != NULL && cfg->method != METHOD_COMPLETE) {
+        fprintf(stderr, "Параметр --board используется только с --method complete\n");
+        return false;
+    }
+    if (cfg->method == METHOD_COMPLETE) {
+        if (!parseBoardSpec(cfg->boardSpec != NULL ? cfg->boardSpec : "", cfg->N, cfg->board)) {
+            return false;
+        }
+
+        const char *boardError = queens_complete_check(cfg->N, cfg->Q, cfg->board);
+        if (boardError != NULL) {
+            fprintf(stderr, "Некорректная доска: %s\n", boardError);
+            return false;
+        }
+    }
+    // Сохраняются только счетчики задач, поэтому контрольные точки есть лишь у подсчета
+    if (cfg->checkpoint.path != NULL && (cfg->method != METHOD_PARALLEL || cfg->output != OUTPUT_COUNT)) {
+        fprintf(stderr, "Контрольные точки поддерживаются только для --method parallel --output count\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void runSearch(const RunConfig *cfg)
+{
+    int N = cfg->N;
+    int Q = cfg->Q;
+    int maxDepth = cfg->maxDepth;
+    SearchMethod method = cfg->method;
+
+    SolutionOutput out;
+    initOutput(&out, cfg->output);
+
+    SearchStats bfsStats;
+    SearchStats bfsCompactStats;
+    SearchStats dfsIterStats;
+    SearchStats dfsRecStats;
+    SearchStats dfsPathStats;
+
+    bool hasBFS = false;
+    bool hasBFSCompact = false;
+    bool hasDFSIter = false;
+    bool hasDFSRec = false;
+    bool hasDFSPath = false;
+    if (method == METHOD_BFS || method == METHOD_ALL) {
+        printf("\n--- Поиск в ШИРИНУ (BFS) ---\n");
+        bfsStats = solveBFS(N, Q, &out);
+        hasBFS = true;
+        printNoSolutionIfNeeded("BFS", N, Q, &bfsStats);
+        printStats("BFS", &bfsStats);
+    }
+
+    if (method == METHOD_BFS_COMPACT || method == METHOD_ALL) {
+        printf("\n--- Поиск в ШИРИНУ (BFS, компактные слои) ---\n");
+        bfsCompactStats = solveBFSCompact(N, Q, &out);
+        hasBFSCompact = true;
+        printNoSolutionIfNeeded("BFS компактный", N, Q, &bfsCompactStats);
+        printStats("BFS компактный", &bfsCompactStats);
+    }
+
+    if (method == METHOD_BFS_PARALLEL) {
+        printf("\n--- Поиск в ШИРИНУ (BFS по слоям, потоков: %d) ---\n", cfg->threads);
+        SearchStats bfsParallelStats = solveParallelBFS(N, Q, cfg->threads, &out);
+        printNoSolutionIfNeeded("BFS параллельный", N, Q, &bfsParallelStats);
+        printStats("BFS параллельный", &bfsParallelStats);
+    }
+
+    if (method == METHOD_DFS_ITER || method == METHOD_ALL) {
+        printf("\n--- Поиск в ГЛУБИНУ (DFS, итерационный, maxDepth=%d) ---\n", maxDepth);
+        dfsIterStats = solveDFSIterative(N, Q, maxDepth, &out);
+        hasDFSIter = true;
+        printNoSolutionIfNeeded("DFS итерационный", N, Q, &dfsIterStats);
+        printStats("DFS итерационный", &dfsIterStats);
+    }
+
+    if (method == METHOD_DFS_REC || method == METHOD_ALL) {
+        printf("\n--- Поиск в ГЛУБИНУ (DFS, рекурсивный, maxDepth=%d) ---\n", maxDepth);
+        dfsRecStats = solveDFSRecursive(N, Q, maxDepth, &out);
+        hasDFSRec = true;
+        printNoSolutionIfNeeded("DFS рекурсивный", N, Q, &dfsRecStats);
+        printStats("DFS рекурсивный", &dfsRecStats);
+    }
+
+    if (method == METHOD_DFS_REC_PATH || method == METHOD_ALL) {
+        printf("\n--- Поиск в ГЛУБИНУ (DFS, рекурсивный с Path, maxDepth=%d) ---\n", maxDepth);
+        dfsPathStats = solveDFSRecursiveWithPath(N, Q, maxDepth, &out);
+        hasDFSPath = true;
+        printNoSolutionIfNeeded("DFS рекурсивный с Path", N, Q, &dfsPathStats);
+        printStats("DFS рекурсивный с Path", &dfsPathStats);
+    }
+
+    if (method == METHOD_PARALLEL) {
+        printf("\n--- Параллельный подсчет (потоков: %d) ---\n", cfg->threads);
+        ParallelStats parStats = solveParallel(N, Q, cfg->threads, &cfg->checkpoint, &out);
+        printParallelStats(&parStats);
+    }
+
+    if (method == METHOD_SYMMETRY) {
+        if (Q != N) {
+            printf("\nПеребор с учетом симметрии возможен только для полной расстановки (Q = N).\n\n");
+        } else {
+            printf("\n--- Перебор с учетом симметрии ---\n");
+            SymmetrySearch symStats = solveSymmetric(N, &out);
+            printSymmetryStats(&symStats);
+        }
+    }
+
+    if (method == METHOD_MIN_CONFLICTS) {
+        if (Q != N) {
+            printf("\nЛокальный поиск строит только полную расстановку (Q = N).\n\n");
+        } else {
+            printf("\n--- Локальный поиск min-conflicts ---\n");
+            LocalSearch localStats = solveMinConflicts(N, &out);
+            printLocalSearchStats(&localStats);
+            freeLocalSearch(&localStats);
+        }
+    }
+
+    if (method == METHOD_MEMO_COUNT) {
+        printf("\n--- Подсчет с мемоизацией (таблица до %d МБ, доски не выводятся) ---\n", cfg->memoMegabytes);
+        MemoSearch memoStats = solveMemoCount(N, Q, cfg->memoMegabytes);
+        printMemoStats(&memoStats);
+    }
+
+    if (method == METHOD_DLX) {
+        printf("\n--- Точное покрытие, Dancing Links (%s) ---\n", cfg->diagonals ? "ферзи" : "ладьи, без диагоналей");
+        CoverStats coverStats = solveQueensCover(N, Q, cfg->diagonals, cfg->firstOnly, &out);
+        printCoverStats("DLX", &coverStats);
+    }
+
+    if (method == METHOD_DLX_BENCH) {
+        printf("\n--- Сравнение Dancing Links с битовым DFS (только подсчет) ---\n");
+        benchmarkCover(N, Q);
+    }
+
+    if (method == METHOD_KERNEL_BENCH) {
+        printf("\n--- Сравнение ядер подсчета поддеревьев (только подсчет) ---\n");
+        benchmarkKernels(N, Q);
+    }
+
+    if (method == METHOD_COMPLETE) {
+        printf("\n--- Достроение частичной расстановки ---\n");
+        solveCompletion(N, Q, cfg->board, cfg->firstOnly, &out);
+    }
+
+    if (method == METHOD_ALL) {
+        printBestSummary(hasBFS ? &bfsStats : NULL, hasBFSCompact ? &bfsCompactStats : NULL, hasDFSIter ? &dfsIterStats : NULL, hasDFSRec ? &dfsRecStats : NULL, hasDFSPath ? &dfsPathStats : NULL);
+    }
+
+    freeOutput(&out);
+}
+
+// Подкоманда bench: прогон методов по сетке N, Q, maxDepth с выводом CSV.
+// Каждая точка повторяется несколько раз, в таблицу идет медиана времени; решения только считаются.
+
+#define DEFAULT_BENCH_REPEATS 5
+#define MAX_BENCH_REPEATS 1000
+
+typedef struct {
+    const char *name;
+    SearchMethod method;
+    bool usesDepth;           // перебирать maxDepth из --max-depth
+} BenchMethod;
+
+static const BenchMethod benchMethods[] = {
+    {"bfs", METHOD_BFS, false},
+    {"bfs_compact", METHOD_BFS_COMPACT, false},
+    {"bfs_parallel", METHOD_BFS_PARALLEL, false},
+    {"dfs_iter", METHOD_DFS_ITER, true},
+    {"dfs_rec", METHOD_DFS_REC, true},
+    {"dfs_rec_path", METHOD_DFS_REC_PATH, true},
+    {"parallel", METHOD_PARALLEL, false},
+    {"symmetry", METHOD_SYMMETRY, false},
+    {"memo_count", METHOD_MEMO_COUNT, false},
+    {"dlx", METHOD_DLX, false},
+};
+
+#define BENCH_METHOD_COUNT (int)(sizeof(benchMethods) / sizeof(benchMethods[0]))
+
+// Итог одного прогона в общих единицах; память и выделения известны не для всех методов
+typedef struct {
+    BigCount solutions;
+    uint64_t expanded;
+    size_t peakBytes;
+    int allocations;
+    bool hasBytes;
+    bool hasAllocations;
+    double seconds;
+} BenchSample;
+
+// Диапазон "A" или "A-B"
+static bool parseRange(const char *text, int *lo, int *hi)
+{
+    char buf[32];
+    const char *dash = strchr(text, '-');
+
+    if (dash == NULL) {
+        if (!parseInt(text, lo)) {
+            return false;
+        }
+        *hi = *lo;
+        return true;
+    }
+
+    size_t len = (size_t)(dash - text);
+    if (len == 0 || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    return parseInt(buf, lo) && parseInt(dash + 1, hi) && *lo <= *hi;
+}
+
+static void sampleFromSearch(BenchSample *s, const SearchStats *st)
+{
+    s->solutions = st->solutionCount;
+    s->expanded = st->expandedStates;
+    s->peakBytes = st->peakBytes;
+    s->allocations = st->allocations;
+    s->hasBytes = true;
+    s->hasAllocations = true;
+}
+
+static BenchSample runBenchOnce(SearchMethod method, int N, int Q, int maxDepth, int threads, int memoMegabytes, SolutionOutput *out)
+{
+    BenchSample s;
+    memset(&s, 0, sizeof(s));
+
+    double start = nowSeconds();
+    if (method == METHOD_BFS) {
+        SearchStats st = solveBFS(N, Q, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_BFS_COMPACT) {
+        SearchStats st = solveBFSCompact(N, Q, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_BFS_PARALLEL) {
+        SearchStats st = solveParallelBFS(N, Q, threads, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_DFS_ITER) {
+        SearchStats st = solveDFSIterative(N, Q, maxDepth, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_DFS_REC) {
+        SearchStats st = solveDFSRecursive(N, Q, maxDepth, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_DFS_REC_PATH) {
+        SearchStats st = solveDFSRecursiveWithPath(N, Q, maxDepth, out);
+        sampleFromSearch(&s, &st);
+    } else if (method == METHOD_PARALLEL) {
+        ParallelStats st = solveParallel(N, Q, threads, NULL, out);
+        s.solutions = st.solutionCount;
+        s.expanded = st.expandedStates;
+        s.peakBytes = st.peakBytes;
+        s.allocations = st.allocations;
+        s.hasBytes = true;
+        s.hasAllocations = true;
+    } else if (method == METHOD_SYMMETRY) {
+        SymmetrySearch st = solveSymmetric(N, out);
+        s.solutions = st.totalCount;
+        s.expanded = st.expandedStates;
+        s.peakBytes = st.peakBytes;
+        s.allocations = st.allocations;
+        s.hasBytes = true;
+        s.hasAllocations = true;
+    } else if (method == METHOD_MEMO_COUNT) {
+        MemoSearch st = solveMemoCount(N, Q, memoMegabytes);
+        s.solutions = st.solutionCount;
+        s.expanded = st.visitedStates;
+        s.peakBytes = st.capacity * sizeof(MemoEntry);
+        s.allocations = 1;
+        s.hasBytes = true;
+        s.hasAllocations = true;
+    } else if (method == METHOD_DLX) {
+        CoverStats st = solveQueensCover(N, Q, true, false, out);
+        s.solutions = st.dlx.solutionCount;
+        s.expanded = st.dlx.searchNodes;
+        s.peakBytes = st.bytes;
+        s.hasBytes = true;
+    }
+    s.seconds = nowSeconds() - start;
+
+    return s;
+}
+
+static int compareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Повторы одной точки сетки и строка CSV; счетчики у повторов совпадают, берутся из последнего
+static void benchPoint(const BenchMethod *bm, int N, int Q, int maxDepth, int repeats, int threads, int memoMegabytes, SolutionOutput *out)
+{
+    double *times = (double *)allocOrDie((size_t)repeats * sizeof(double));
+    BenchSample s;
+    char countBuf[48];
+
+    memset(&s, 0, sizeof(s));
+    for (int r = 0; r < repeats; r++) {
+        s = runBenchOnce(bm->method, N, Q, maxDepth, threads, memoMegabytes, out);
+        times[r] = s.seconds;
+    }
+
+    qsort(times, (size_t)repeats, sizeof(double), compareDoubles);
+    double median = (repeats % 2 == 1) ? times[repeats / 2] : (times[repeats / 2 - 1] + times[repeats / 2]) / 2.0;
+
+    printf("%s,%d,%d,", bm->name, N, Q);
+    if (bm->usesDepth) {
+        printf("%d", maxDepth);
+    }
+    printf(",%d,%.9f,%.9f,%s,%" PRIu64 ",", repeats, median, times[0],
+           formatBigCount(s.solutions, countBuf, sizeof(countBuf)), s.expanded);
+    if (median > 0.0) {
+        printf("%.0f", (double)s.expanded / median);
+    }
+    printf(",");
+    if (s.hasBytes) {
+        printf("%zu", s.peakBytes);
+    }
+    printf(",");
+    if (s.hasAllocations) {
+        printf("%d", s.allocations);
+    }
+    printf("\n");
+    fflush(stdout);
+
+    free(times);
+}
+
+static int runBenchCommand(int argc, char *argv[])
+{
+    int nLo = 4, nHi = 10;
+    int qLo = 0, qHi = 0;             // 0 - Q = N
+    int depthLo = 0, depthHi = 0;     // 0 - maxDepth = Q
+    int repeats = DEFAULT_BENCH_REPEATS;
+    int memoMegabytes = DEFAULT_MEMO_MB;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (cpus > 0 && cpus <= MAX_THREADS) ? (int)cpus : 1;
+    bool selected[BENCH_METHOD_COUNT];
+    bool ok = true;
+
+    for (int m = 0; m < BENCH_METHOD_COUNT; m++) {
+        selected[m] = true;
+    }
+
+    for (int i = 2; ok && i < argc; i++) {
+        const char *opt = argv[i];
+
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Не указано значение параметра %s\n", opt);
+            return 1;
+        }
+
+        const char *value = argv[++i];
+        if (strcmp(opt, "--n") == 0) {
+            ok = parseRange(value, &nLo, &nHi) && nLo >= 1 && nHi <= MAX_N;
+        } else if (strcmp(opt, "--q") == 0) {
+            ok = parseRange(value, &qLo, &qHi) && qLo >= 1;
+        } else if (strcmp(opt, "--max-depth") == 0) {
+            ok = parseRange(value, &depthLo, &depthHi) && depthLo >= 1;
+        } else if (strcmp(opt, "--repeat") == 0) {
+            ok = parseInt(value, &repeats) && repeats >= 1 && repeats <= MAX_BENCH_REPEATS;
+        } else if (strcmp(opt, "--threads") == 0) {
+            ok = parseInt(value, &threads) && threads >= 1 && threads <= MAX_THREADS;
+        } else if (strcmp(opt, "--memo-mb") == 0) {
+            ok = parseInt(value, &memoMegabytes) && memoMegabytes >= 1 && memoMegabytes <= MAX_MEMO_MB;
+        } else if (strcmp(opt, "--methods") == 0) {
+            char buf[256];
+            snprintf(buf, sizeof(buf), "%s", value);
+            for (int m = 0; m < BENCH_METHOD_COUNT; m++) {
+                selected[m] = false;
+            }
+            for (char *name = strtok(buf, ","); ok && name != NULL; name = strtok(NULL, ",")) {
+                int m = 0;
+                while (m < BENCH_METHOD_COUNT && strcmp(name, benchMethods[m].name) != 0) {
+                    m++;
+                }
+                ok = m < BENCH_METHOD_COUNT;
+                if (ok) {
+                    selected[m] = true;
+                }
+            }
+        } else {
+            fprintf(stderr, "Неизвестный параметр: %s\n", opt);
+            return 1;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Некорректное значение параметра %s: %s\n", opt, value);
+            return 1;
+        }
+    }
+
+    // Q не больше N, поэтому такой диапазон Q не дает ни одной точки замера
+    if (qLo > nHi) {
+        fprintf(stderr, "Диапазон --q %d-%d не пересекается с 1..N ни при одном N из %d-%d\n", qLo, qHi, nLo, nHi);
+        return 1;
+    }
+
+    SolutionOutput countOnly;
+    initOutput(&countOnly, OUTPUT_COUNT);
+
+    printf("method,N,Q,max_depth,repeats,median_seconds,min_seconds,solutions,expanded_states,states_per_second,peak_bytes,allocations\n");
+    for (int m = 0; m < BENCH_METHOD_COUNT; m++) {
+        const BenchMethod *bm = &benchMethods[m];
+        if (!selected[m]) {
+            continue;
+        }
+
+        for (int N = nLo; N <= nHi; N++) {
+            int fromQ = qLo ? qLo : N;
+            int toQ = qLo ? (qHi < N ? qHi : N) : N;
+
+            for (int Q = fromQ; Q <= toQ; Q++) {
+                // Симметрия определена только для полной расстановки
+                if (bm->method == METHOD_SYMMETRY && Q != N) {
+                    continue;
+                }
+                if (!bm->usesDepth || depthLo == 0) {
+                    benchPoint(bm, N, Q, Q, repeats, threads, memoMegabytes, &countOnly);
+                    continue;
+                }
+                for (int depth = depthLo; depth <= depthHi && depth <= Q; depth++) {
+                    benchPoint(bm, N, Q, depth, repeats, threads, memoMegabytes, &countOnly);
+                }
+            }
+        }
+    }
+
+    freeOutput(&countOnly);
+    return 0;
+}
+
+// Подкоманды распределенного подсчета: plan, run-shard, merge
+static int runShardCommand(int argc, char *argv[])
+{
+    const char *command = argv[1];
+    const char *jobPath = NULL;
+    const char *resultPath = NULL;
+    char **results = (char **)allocOrDie((size_t)argc * sizeof(char *));
+    int resultCount = 0;
+    int N = 0, Q = 0, shards = 0, shard = -1;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int threads = (cpus > 0 && cpus <= MAX_THREADS) ? (int)cpus : 1;
+    bool ok = true;
+
+    for (int i = 2; ok && i < argc; i++) {
+        const char *opt = argv[i];
+
+        // У merge файлы результатов перечисляются без ключа, другим подкомандам они не нужны
+        if (opt[0] != '-') {
+            if (strcmp(command, "merge") != 0) {
+                fprintf(stderr, "Лишний аргумент: %s\n", opt);
+                ok = false;
+                break;
+            }
+            results[resultCount++] = argv[i];
+            continue;
+        }
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Не указано значение параметра %s\n", opt);
+            ok = false;
+            break;
+        }
+
+        const char *value = argv[++i];
+        if (strcmp(opt, "--job") == 0) {
+            jobPath = value;
+        } else if (strcmp(opt, "--result") == 0) {
+            resultPath = value;
+        } else if (strcmp(opt, "--n") == 0) {
+            ok = parseInt(value, &N);
+        } else if (strcmp(opt, "--q") == 0) {
+            ok = parseInt(value, &Q);
+        } else if (strcmp(opt, "--shards") == 0) {
+            ok = parseInt(value, &shards);
+        } else if (strcmp(opt, "--shard") == 0) {
+            ok = parseInt(value, &shard);
+        } else if (strcmp(opt, "--threads") == 0) {
+            ok = parseInt(value, &threads) && threads >= 1 && threads <= MAX_THREADS;
+        } else {
+            fprintf(stderr, "Неизвестный параметр: %s\n", opt);
+            ok = false;
+        }
+
+        if (!ok) {
+            fprintf(stderr, "Некорректное значение параметра %s: %s\n", opt, value);
+        }
+    }
+
+    if (ok && jobPath == NULL) {
+        fprintf(stderr, "Не указан файл задания --job\n");
+        ok = false;
+    }
+
+    if (ok && strcmp(command, "plan") == 0) {
+        if (Q == 0) {
+            Q = N;
+        }
+        if (N < 1 || N > MAX_N || Q < 1 || Q > N || shards < 1 || shards > MAX_SHARDS) {
+            fprintf(stderr, "Для plan нужны --n (1..%d), --q (1..N) и --shards (1..%d)\n", MAX_N, MAX_SHARDS);
+            ok = false;
+        } else {
+            ok = planShards(N, Q, shards, jobPath);
+        }
+    } else if (ok && strcmp(command, "run-shard") == 0) {
+        if (shard < 0 || resultPath == NULL) {
+            fprintf(stderr, "Для run-shard нужны --shard и --result\n");
+            ok = false;
+        } else {
+            ok = runShard(jobPath, shard, threads, resultPath);
+        }
+    } else if (ok && strcmp(command, "merge") == 0) {
+        ok = mergeShards(jobPath, results, resultCount);
+    } else if (ok) {
+        fprintf(stderr, "Неизвестная подкоманда: %s\n", command);
+        ok = false;
+    }
+
+    free(results);
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    RunConfig cfg;
+
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return runBenchCommand(argc, argv);
+    }
+    if (argc > 1 && argv[1][0] != '-') {
+        return runShardCommand(argc, argv);
+    }
+
+    if (argc > 1) {
+        if (!parseArgs(argc, argv, &cfg)) {
+            return 1;
+        }
+    } else {
+        readInteractiveConfig(&cfg);
     }
 
+    runSearch(&cfg);
     return 0;
 }
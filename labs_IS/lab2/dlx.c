@@ -0,0 +1,348 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dlx.h"
+
+// Узел: для заголовка элемента top хранит число опций с этим элементом (len),
+// для разделителя опций top <= 0, для обычного узла - номер элемента.
+typedef struct {
+    int top;
+    int ulink;
+    int dlink;
+} DlxNode;
+
+// Заголовок элемента в двусвязном списке еще не покрытых элементов
+typedef struct {
+    int llink;
+    int rlink;
+} DlxItem;
+
+struct Dlx {
+    int primaryCount;
+    int itemCount;
+    DlxItem *items;           // 0 - корень основных, itemCount + 1 - корень вторичных
+    DlxNode *nodes;           // 1..itemCount - заголовки, дальше опции через разделители
+    int nodeCount;
+    int nodeCapacity;
+    int lastSpacer;
+    int optionCount;
+
+    // Состояние поиска
+    DlxMode mode;
+    DlxSolutionFn onSolution;
+    void *ctx;
+    int *choice;              // выбранный узел на каждом уровне
+    int *options;             // номера опций текущего решения для обработчика
+    bool stop;
+    DlxStats stats;
+};
+
+static void *dlxAlloc(size_t bytes)
+{
+    void *ptr = malloc(bytes);
+    if (!ptr) {
+        fprintf(stderr, "Ошибка выделения памяти для Dancing Links.\n");
+        exit(EXIT_FAILURE);
+    }
+    return ptr;
+}
+
+static int appendNode(Dlx *dlx, int top, int ulink, int dlink)
+{
+    if (dlx->nodeCount == dlx->nodeCapacity) {
+        int capacity = dlx->nodeCapacity * 2;
+        DlxNode *grown = (DlxNode *)realloc(dlx->nodes, (size_t)capacity * sizeof(DlxNode));
+        if (!grown) {
+            fprintf(stderr, "Ошибка выделения памяти для Dancing Links.\n");
+            exit(EXIT_FAILURE);
+        }
+        dlx->nodes = grown;
+        dlx->nodeCapacity = capacity;
+    }
+
+    int idx = dlx->nodeCount++;
+    dlx->nodes[idx].top = top;
+    dlx->nodes[idx].ulink = ulink;
+    dlx->nodes[idx].dlink = dlink;
+    return idx;
+}
+
+Dlx *dlxCreate(int primaryItems, int secondaryItems)
+{
+    if (primaryItems < 0 || secondaryItems < 0) {
+        fprintf(stderr, "Ошибка: отрицательное число элементов.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Dlx *dlx = (Dlx *)dlxAlloc(sizeof(Dlx));
+    int itemCount = primaryItems + secondaryItems;
+
+    dlx->primaryCount = primaryItems;
+    dlx->itemCount = itemCount;
+    dlx->items = (DlxItem *)dlxAlloc((size_t)(itemCount + 2) * sizeof(DlxItem));
+    dlx->nodeCapacity = (itemCount + 2) * 4;
+    dlx->nodes = (DlxNode *)dlxAlloc((size_t)dlx->nodeCapacity * sizeof(DlxNode));
+    dlx->nodeCount = 0;
+    dlx->optionCount = 0;
+    dlx->choice = NULL;
+    dlx->options = NULL;
+
+    // Два кольцевых списка: основные элементы с корнем 0 и вторичные с корнем itemCount + 1
+    int secondaryRoot = itemCount + 1;
+    for (int i = 0; i <= itemCount + 1; i++) {
+        dlx->items[i].llink = i - 1;
+        dlx->items[i].rlink = i + 1;
+    }
+    dlx->items[0].llink = primaryItems;
+    dlx->items[primaryItems].rlink = 0;
+    dlx->items[secondaryRoot].llink = (secondaryItems > 0) ? itemCount : secondaryRoot;
+    dlx->items[secondaryRoot].rlink = (secondaryItems > 0) ? primaryItems + 1 : secondaryRoot;
+    if (secondaryItems > 0) {
+        dlx->items[primaryItems + 1].llink = secondaryRoot;
+        dlx->items[itemCount].rlink = secondaryRoot;
+    }
+
+    appendNode(dlx, 0, 0, 0);
+    for (int i = 1; i <= itemCount; i++) {
+        appendNode(dlx, 0, i, i);
+    }
+
+    dlx->lastSpacer = appendNode(dlx, 0, 0, 0);
+    return dlx;
+}
+
+int dlxAddOption(Dlx *dlx, const int *items, int count)
+{
+    if (count <= 0) {
+        fprintf(stderr, "Ошибка: пустая опция.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int first = dlx->nodeCount;
+
+    for (int k = 0; k < count; k++) {
+        int item = items[k] + 1;
+
+        if (item < 1 || item > dlx->itemCount) {
+            fprintf(stderr, "Ошибка: элемент %d вне диапазона.\n", items[k]);
+            exit(EXIT_FAILURE);
+        }
+        for (int j = 0; j < k; j++) {
+            if (items[j] == items[k]) {
+                fprintf(stderr, "Ошибка: элемент %d повторяется в опции.\n", items[k]);
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        // Вставка в конец вертикального списка элемента
+        int last = dlx->nodes[item].ulink;
+        int node = appendNode(dlx, item, last, item);
+        dlx->nodes[last].dlink = node;
+        dlx->nodes[item].ulink = node;
+        dlx->nodes[item].top++;
+    }
+
+    // Разделитель: вверх - на первый узел предыдущей опции, вниз - на последний узел следующей
+    dlx->nodes[dlx->lastSpacer].dlink = dlx->nodeCount - 1;
+    dlx->optionCount++;
+    dlx->lastSpacer = appendNode(dlx, -dlx->optionCount, first, 0);
+
+    return dlx->optionCount - 1;
+}
+
+// Номер опции узла: номер записан в разделителе за ней
+static int optionOf(const Dlx *dlx, int node)
+{
+    while (dlx->nodes[node].top > 0) {
+        node++;
+    }
+    return -dlx->nodes[node].top - 1;
+}
+
+static void hide(Dlx *dlx, int p)
+{
+    DlxNode *nodes = dlx->nodes;
+
+    for (int q = p + 1; q != p; ) {
+        int x = nodes[q].top;
+        int u = nodes[q].ulink;
+        int d = nodes[q].dlink;
+
+        if (x <= 0) {
+            q = u;
+        } else {
+            nodes[u].dlink = d;
+            nodes[d].ulink = u;
+            nodes[x].top--;
+            dlx->stats.updates++;
+            q++;
+        }
+    }
+}
+
+static void unhide(Dlx *dlx, int p)
+{
+    DlxNode *nodes = dlx->nodes;
+
+    for (int q = p - 1; q != p; ) {
+        int x = nodes[q].top;
+        int u = nodes[q].ulink;
+        int d = nodes[q].dlink;
+
+        if (x <= 0) {
+            q = d;
+        } else {
+            nodes[u].dlink = q;
+            nodes[d].ulink = q;
+            nodes[x].top++;
+            q--;
+        }
+    }
+}
+
+static void cover(Dlx *dlx, int item)
+{
+    for (int p = dlx->nodes[item].dlink; p != item; p = dlx->nodes[p].dlink) {
+        hide(dlx, p);
+    }
+
+    int l = dlx->items[item].llink;
+    int r = dlx->items[item].rlink;
+    dlx->items[l].rlink = r;
+    dlx->items[r].llink = l;
+}
+
+static void uncover(Dlx *dlx, int item)
+{
+    int l = dlx->items[item].llink;
+    int r = dlx->items[item].rlink;
+    dlx->items[l].rlink = item;
+    dlx->items[r].llink = item;
+
+    for (int p = dlx->nodes[item].ulink; p != item; p = dlx->nodes[p].ulink) {
+        unhide(dlx, p);
+    }
+}
+
+// Основной элемент с наименьшим числом опций (эвристика MRV); -1 - все покрыты
+static int chooseItem(const Dlx *dlx)
+{
+    int best = -1;
+    int bestLen = 0;
+
+    for (int i = dlx->items[0].rlink; i != 0; i = dlx->items[i].rlink) {
+        int len = dlx->nodes[i].top;
+        if (best < 0 || len < bestLen) {
+            best = i;
+            bestLen = len;
+            if (len == 0) {
+                break;
+            }
+        }
+    }
+
+    return best;
+}
+
+static void reportSolution(Dlx *dlx, int level)
+{
+    dlx->stats.solutionCount++;
+
+    if (dlx->mode != DLX_COUNT && dlx->onSolution != NULL) {
+        for (int k = 0; k < level; k++) {
+            dlx->options[k] = optionOf(dlx, dlx->choice[k]);
+        }
+        dlx->onSolution(dlx->options, level, dlx->ctx);
+    }
+
+    if (dlx->mode == DLX_FIRST) {
+        dlx->stop = true;
+    }
+}
+
+static void search(Dlx *dlx, int level)
+{
+    dlx->stats.searchNodes++;
+
+    int item = chooseItem(dlx);
+    if (item < 0) {
+        reportSolution(dlx, level);
+        return;
+    }
+    if (dlx->nodes[item].top == 0) {
+        return;
+    }
+
+    cover(dlx, item);
+
+    for (int x = dlx->nodes[item].dlink; x != item && !dlx->stop; x = dlx->nodes[x].dlink) {
+        dlx->choice[level] = x;
+
+        // Покрыть остальные элементы опции, обходя ее вправо по кругу
+        for (int p = x + 1; p != x; ) {
+            int top = dlx->nodes[p].top;
+            if (top <= 0) {
+                p = dlx->nodes[p].ulink;
+            } else {
+                cover(dlx, top);
+                p++;
+            }
+        }
+
+        search(dlx, level + 1);
+
+        for (int p = x - 1; p != x; ) {
+            int top = dlx->nodes[p].top;
+            if (top <= 0) {
+                p = dlx->nodes[p].dlink;
+            } else {
+                uncover(dlx, top);
+                p--;
+            }
+        }
+    }
+
+    uncover(dlx, item);
+}
+
+DlxStats dlxSolve(Dlx *dlx, DlxMode mode, DlxSolutionFn onSolution, void *ctx)
+{
+    // Каждая выбранная опция покрывает хотя бы один основной элемент, глубина не больше их числа
+    int depth = dlx->primaryCount + 1;
+
+    dlx->mode = mode;
+    dlx->onSolution = onSolution;
+    dlx->ctx = ctx;
+    dlx->stop = false;
+    dlx->stats.solutionCount = 0;
+    dlx->stats.searchNodes = 0;
+    dlx->stats.updates = 0;
+    dlx->choice = (int *)dlxAlloc((size_t)depth * sizeof(int));
+    dlx->options = (int *)dlxAlloc((size_t)depth * sizeof(int));
+
+    search(dlx, 0);
+
+    free(dlx->choice);
+    free(dlx->options);
+    dlx->choice = NULL;
+    dlx->options = NULL;
+    return dlx->stats;
+}
+
+size_t dlxBytes(const Dlx *dlx)
+{
+    return (size_t)dlx->nodeCapacity * sizeof(DlxNode) + (size_t)(dlx->itemCount + 2) * sizeof(DlxItem);
+}
+
+void dlxFree(Dlx *dlx)
+{
+    if (!dlx) {
+        return;
+    }
+
+    free(dlx->items);
+    free(dlx->nodes);
+    free(dlx);
+}
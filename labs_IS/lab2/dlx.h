@@ -0,0 +1,41 @@
+#ifndef DLX_H
+#define DLX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Алгоритм X на танцующих ссылках (Dancing Links) для задач точного покрытия.
+// Все ссылки - индексы в общих массивах, а не указатели на отдельно выделенные узлы.
+// Основные элементы должны быть покрыты ровно один раз, вторичные - не более одного раза.
+
+typedef enum {
+    DLX_COUNT = 1,            // только подсчет решений
+    DLX_FIRST = 2,            // остановка на первом решении
+    DLX_ENUMERATE = 3         // каждое решение передается в обработчик
+} DlxMode;
+
+// Обработчик решения: номера опций в порядке выбора
+typedef void (*DlxSolutionFn)(const int *options, int count, void *ctx);
+
+typedef struct {
+    uint64_t solutionCount;
+    uint64_t searchNodes;     // вершин дерева поиска
+    uint64_t updates;         // изменений ссылок при скрытии строк
+} DlxStats;
+
+typedef struct Dlx Dlx;
+
+// Элементы 0..primaryItems-1 - основные, primaryItems..primaryItems+secondaryItems-1 - вторичные
+Dlx *dlxCreate(int primaryItems, int secondaryItems);
+
+// Опция - набор различных элементов; возвращает номер опции (с нуля)
+int dlxAddOption(Dlx *dlx, const int *items, int count);
+
+DlxStats dlxSolve(Dlx *dlx, DlxMode mode, DlxSolutionFn onSolution, void *ctx);
+
+// Объем узловых массивов в байтах
+size_t dlxBytes(const Dlx *dlx);
+
+void dlxFree(Dlx *dlx);
+
+#endif
@@ -4,6 +4,8 @@ from dataclasses import dataclass
 from collections import deque
 from typing import List, Optional
 
+from queens_lib import QueensIterator, MAX_N as ITER_MAX_N
+
 
 # =========================
 # Алгоритм поиска
@@ -23,6 +25,24 @@ class SearchResult:
     q: int
     expanded_states: int
     steps_to_first_solution: int
+    exhausted: bool = True                  # False - решения еще подгружаются из итератора
+    iterator: Optional[QueensIterator] = None
+
+    def fetch_next(self) -> bool:
+        """Догружает одно решение из итератора; False - решений больше нет."""
+        if self.exhausted or self.iterator is None:
+            return False
+        board = self.iterator.next_board()
+        if self.steps_to_first_solution == -1 and board is not None:
+            self.steps_to_first_solution = self.iterator.expanded_states
+        self.expanded_states = self.iterator.expanded_states
+        if board is None:
+            self.exhausted = True
+            self.iterator.close()
+            self.iterator = None
+            return False
+        self.boards.append(board)
+        return True
 
 
 def create_state(n: int, row: int) -> State:
@@ -161,7 +181,29 @@ def solve_dfs_limited(n: int, q: int, max_depth: int) -> SearchResult:
     )
 
 
+def open_lazy_result(n: int, q: int) -> SearchResult:
+    # Решения не перебираются заранее: следующее берется из C-итератора по запросу
+    result = SearchResult(
+        boards=[],
+        n=n,
+        q=q,
+        expanded_states=0,
+        steps_to_first_solution=-1,
+        exhausted=False,
+        iterator=QueensIterator(n, q)
+    )
+    result.fetch_next()
+    return result
+
+
 def solve_queens(n: int, q: int, method: str, max_depth: int) -> SearchResult:
+    if method == "DFS (итератор)":
+        if n < 1 or n > ITER_MAX_N:
+            raise ValueError(f"Размерность доски должна быть в диапазоне 1..{ITER_MAX_N}.")
+        if q < 1 or q > n:
+            raise ValueError("Количество ферзей должно быть в диапазоне 1..N.")
+        return open_lazy_result(n, q)
+
     if n < 1 or n > 12:
         raise ValueError("Размерность доски должна быть в диапазоне 1..12.")
     if q < 1 or q > n:
@@ -222,7 +264,7 @@ class QueensApp:
 
         tk.Label(top, text="Метод").grid(row=1, column=0, pady=(12, 0), sticky="w")
 
-        self.method_box = ttk.Combobox(top, state="readonly", width=18, values=["BFS", "DFS"])
+        self.method_box = ttk.Combobox(top, state="readonly", width=18, values=["BFS", "DFS", "DFS (итератор)"])
         self.method_box.grid(row=1, column=1, columnspan=3, pady=(12, 0), sticky="w")
         self.method_box.set("BFS")
         self.method_box.bind("<<ComboboxSelected>>", lambda e: self._on_method_change())
@@ -292,6 +334,8 @@ class QueensApp:
             if method == "DFS":
                 max_depth = self._read_int(self.var_depth.get(), "MaxDepth")
 
+            if self.result and self.result.iterator:
+                self.result.iterator.close()
             self.result = solve_queens(x, q, method, max_depth)
             self.current_index = 0
 
@@ -304,7 +348,8 @@ class QueensApp:
     def _update_controls(self):
         if self.result and self.result.boards:
             total = len(self.result.boards)
-            self.lbl_solution.config(text=f"Решение {self.current_index + 1} из {total}")
+            total_text = str(total) if self.result.exhausted else f"{total}+"
+            self.lbl_solution.config(text=f"Решение {self.current_index + 1} из {total_text}")
 
             first_text = (
                 str(self.result.steps_to_first_solution)
@@ -314,7 +359,7 @@ class QueensApp:
                 text=f"Состояний: {self.result.expanded_states}    До первого решения: {first_text}"
             )
 
-            btn_state = tk.NORMAL if total > 1 else tk.DISABLED
+            btn_state = tk.NORMAL if total > 1 or not self.result.exhausted else tk.DISABLED
             self.btn_prev.config(state=btn_state)
             self.btn_next.config(state=btn_state)
         else:
@@ -326,6 +371,8 @@ class QueensApp:
     def show_prev(self):
         if not self.result or not self.result.boards:
             return
+        if self.current_index == 0 and not self.result.exhausted:
+            return
         self.current_index = (self.current_index - 1) % len(self.result.boards)
         self._update_controls()
         self.redraw()
@@ -333,6 +380,8 @@ class QueensApp:
     def show_next(self):
         if not self.result or not self.result.boards:
             return
+        if self.current_index + 1 == len(self.result.boards):
+            self.result.fetch_next()
         self.current_index = (self.current_index + 1) % len(self.result.boards)
         self._update_controls()
         self.redraw()
@@ -0,0 +1,215 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "queens_complete.h"
+
+// Маски занятых линий в абсолютной нумерации: диагональ r + c, антидиагональ c - r + N - 1.
+// Свободные столбцы любой строки r получаются сдвигами масок, без просмотра ферзей.
+typedef struct {
+    int N;
+    uint32_t mask;
+    uint32_t cols;
+    uint64_t diag;
+    uint64_t anti;
+    uint32_t rowsLeft;        // строки 0..Q-1, где ферзя еще нет
+    int board[32];
+    uint64_t limit;
+    QueensSolutionFn onSolution;
+    void *ctx;
+    int stop;
+    QueensCompleteStats stats;
+} Completion;
+
+// Приемник первого решения для queens_complete_first
+typedef struct {
+    int *out;
+    int N;
+} FirstSolution;
+
+static uint32_t freeInRow(const Completion *c, int row)
+{
+    uint32_t diag = (uint32_t)(c->diag >> row);
+    uint32_t anti = (uint32_t)(c->anti >> (c->N - 1 - row));
+    return ~(c->cols | diag | anti) & c->mask;
+}
+
+static void place(Completion *c, int row, int col)
+{
+    c->board[row] = col;
+    c->cols |= 1u << col;
+    c->diag |= 1ULL << (row + col);
+    c->anti |= 1ULL << (col - row + c->N - 1);
+    c->rowsLeft &= ~(1u << row);
+}
+
+static void lift(Completion *c, int row, int col)
+{
+    c->board[row] = -1;
+    c->cols &= ~(1u << col);
+    c->diag &= ~(1ULL << (row + col));
+    c->anti &= ~(1ULL << (col - row + c->N - 1));
+    c->rowsLeft |= 1u << row;
+}
+
+static void foundSolution(Completion *c)
+{
+    c->stats.solutions++;
+
+    if (c->onSolution != NULL && !c->onSolution(c->board, c->ctx)) {
+        c->stop = 1;
+    }
+    if (c->limit != 0 && c->stats.solutions >= c->limit) {
+        c->stop = 1;
+    }
+}
+
+static void completeSearch(Completion *c)
+{
+    c->stats.nodes++;
+
+    if (c->rowsLeft == 0) {
+        foundSolution(c);
+        return;
+    }
+
+    // Строка с наименьшим числом свободных столбцов; пустая строка - тупик
+    int bestRow = -1;
+    int bestCount = 33;
+    uint32_t bestFree = 0;
+
+    for (uint32_t rows = c->rowsLeft; rows != 0; rows &= rows - 1) {
+        int row = __builtin_ctz(rows);
+        uint32_t freeCols = freeInRow(c, row);
+        int count = __builtin_popcount(freeCols);
+
+        if (count < bestCount) {
+            bestRow = row;
+            bestCount = count;
+            bestFree = freeCols;
+            if (count <= 1) {
+                break;
+            }
+        }
+    }
+
+    if (bestCount == 0) {
+        return;
+    }
+
+    // Последняя строка в режиме подсчета: каждый свободный столбец - решение
+    if ((c->rowsLeft & (c->rowsLeft - 1)) == 0 && c->onSolution == NULL && c->limit == 0) {
+        c->stats.solutions += (uint64_t)bestCount;
+        c->stats.nodes += (uint64_t)bestCount;
+        return;
+    }
+
+    while (bestFree != 0 && !c->stop) {
+        int col = __builtin_ctz(bestFree);
+        bestFree &= bestFree - 1;
+
+        place(c, bestRow, col);
+        completeSearch(c);
+        lift(c, bestRow, col);
+    }
+}
+
+const char *queens_complete_check(int N, int Q, const int *board)
+{
+    if (N < 1 || N > 32 || Q < 1 || Q > N) {
+        return "Размер доски или число ферзей вне допустимого диапазона";
+    }
+
+    uint32_t cols = 0;
+    uint64_t diag = 0;
+    uint64_t anti = 0;
+
+    for (int row = 0; row < N; row++) {
+        int col = board[row];
+        if (col == -1) {
+            continue;
+        }
+        if (col < 0 || col >= N) {
+            return "Столбец ферзя вне доски";
+        }
+        if (row >= Q) {
+            return "Ферзь стоит вне строк 1..Q";
+        }
+
+        uint32_t colBit = 1u << col;
+        uint64_t diagBit = 1ULL << (row + col);
+        uint64_t antiBit = 1ULL << (col - row + N - 1);
+
+        if ((cols & colBit) || (diag & diagBit) || (anti & antiBit)) {
+            return "Ферзи бьют друг друга";
+        }
+
+        cols |= colBit;
+        diag |= diagBit;
+        anti |= antiBit;
+    }
+
+    return NULL;
+}
+
+int queens_complete_run(int N, int Q, const int *board, uint64_t limit, QueensSolutionFn onSolution, void *ctx, QueensCompleteStats *stats)
+{
+    stats->solutions = 0;
+    stats->nodes = 0;
+
+    if (queens_complete_check(N, Q, board) != NULL) {
+        return 0;
+    }
+
+    Completion c;
+    memset(&c, 0, sizeof(c));
+    c.N = N;
+    c.mask = (N >= 32) ? UINT32_MAX : ((1u << N) - 1u);
+    c.rowsLeft = (Q >= 32) ? UINT32_MAX : ((1u << Q) - 1u);
+    c.limit = limit;
+    c.onSolution = onSolution;
+    c.ctx = ctx;
+
+    for (int row = 0; row < N; row++) {
+        c.board[row] = -1;
+    }
+    for (int row = 0; row < N; row++) {
+        if (board[row] != -1) {
+            place(&c, row, board[row]);
+        }
+    }
+
+    completeSearch(&c);
+    *stats = c.stats;
+    return 1;
+}
+
+uint64_t queens_complete_count(int N, int Q, const int *board)
+{
+    QueensCompleteStats stats;
+
+    if (!queens_complete_run(N, Q, board, 0, NULL, NULL, &stats)) {
+        return UINT64_MAX;
+    }
+
+    return stats.solutions;
+}
+
+static int copyFirst(const int *board, void *ctx)
+{
+    FirstSolution *first = (FirstSolution *)ctx;
+    memcpy(first->out, board, (size_t)first->N * sizeof(int));
+    return 0;
+}
+
+int queens_complete_first(int N, int Q, const int *board, int *out)
+{
+    QueensCompleteStats stats;
+    FirstSolution first = {out, N};
+
+    if (!queens_complete_run(N, Q, board, 1, copyFirst, &first, &stats)) {
+        return -1;
+    }
+
+    return stats.solutions > 0 ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+#ifndef QUEENS_COMPLETE_H
+#define QUEENS_COMPLETE_H
+
+#include <stdint.h>
+
+// Достроение частичной расстановки: ферзи могут стоять в любых строках, а не только в префиксе.
+// Цель та же, что у перебора с нуля: по ферзю в каждой из строк 0..Q-1, строки Q..N-1 пусты.
+// Доска: board[row] = столбец (0..N-1) или -1, если строка пуста.
+
+typedef struct {
+    uint64_t solutions;
+    uint64_t nodes;           // раскрытых состояний, включая исходную доску
+} QueensCompleteStats;
+
+// Обработчик достроенной доски board[0..N-1]; 0 - остановить перебор
+typedef int (*QueensSolutionFn)(const int *board, void *ctx);
+
+// Проверка доски за O(N) по битовым маскам: NULL, если доска допустима, иначе текст ошибки
+const char *queens_complete_check(int N, int Q, const int *board);
+
+// Перебор достроений: следующей заполняется строка с наименьшим числом свободных столбцов.
+// limit - предел числа решений (0 - без предела); onSolution может быть NULL (только подсчет).
+// Возвращает 0, если доска недопустима.
+int queens_complete_run(int N, int Q, const int *board, uint64_t limit, QueensSolutionFn onSolution, void *ctx, QueensCompleteStats *stats);
+
+// Число достроений; UINT64_MAX, если доска недопустима
+uint64_t queens_complete_count(int N, int Q, const int *board);
+
+// Первое достроение в out[0..N-1]: 1 - найдено, 0 - достроений нет, -1 - доска недопустима
+int queens_complete_first(int N, int Q, const int *board, int *out);
+
+#endif
@@ -0,0 +1,119 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "queens_iter.h"
+
+// Уровень явного стека: занятые столбцы и диагонали строки и еще не опробованные столбцы
+typedef struct {
+    uint32_t cols;
+    uint32_t diag;
+    uint32_t anti;
+    uint32_t untried;
+} IterLevel;
+
+struct QueensIter {
+    int N;
+    int Q;
+    uint32_t mask;
+    int depth;          // текущая строка; -1 - перебор завершен
+    int *board;
+    IterLevel *levels;
+    uint64_t count;
+    uint64_t expanded;
+};
+
+QueensIter *queens_iter_open(int N, int Q)
+{
+    if (N < 1 || N > 32 || Q < 1 || Q > N) {
+        return NULL;
+    }
+
+    QueensIter *it = (QueensIter *)calloc(1, sizeof(QueensIter));
+    if (!it) {
+        return NULL;
+    }
+
+    it->board = (int *)malloc(sizeof(int) * N);
+    it->levels = (IterLevel *)calloc((size_t)Q, sizeof(IterLevel));
+    if (!it->board || !it->levels) {
+        queens_iter_close(it);
+        return NULL;
+    }
+
+    it->N = N;
+    it->Q = Q;
+    it->mask = (N >= 32) ? UINT32_MAX : ((1u << N) - 1u);
+    it->depth = 0;
+    it->levels[0].untried = it->mask;
+    it->expanded = 1;
+
+    for (int i = 0; i < N; i++) {
+        it->board[i] = -1;
+    }
+
+    return it;
+}
+
+int queens_iter_next(QueensIter *it, int *board)
+{
+    if (!it) {
+        return 0;
+    }
+
+    // Продолжаем с того места, где остановился прошлый вызов
+    while (it->depth >= 0) {
+        IterLevel *level = &it->levels[it->depth];
+
+        if (level->untried == 0) {
+            it->board[it->depth] = -1;
+            it->depth--;
+            continue;
+        }
+
+        uint32_t bit = level->untried & (~level->untried + 1u);
+        level->untried ^= bit;
+        it->board[it->depth] = __builtin_ctz(bit);
+
+        // Полная расстановка - целевое состояние: оно тоже раскрыто, как в solveDFSIterative
+        if (it->depth + 1 == it->Q) {
+            it->expanded++;
+            it->count++;
+            for (int i = 0; i < it->N; i++) {
+                board[i] = it->board[i];
+            }
+            return 1;
+        }
+
+        IterLevel *next = level + 1;
+        next->cols = level->cols | bit;
+        next->diag = ((level->diag | bit) << 1) & it->mask;
+        next->anti = (level->anti | bit) >> 1;
+        next->untried = ~(next->cols | next->diag | next->anti) & it->mask;
+
+        it->depth++;
+        it->expanded++;
+    }
+
+    return 0;
+}
+
+uint64_t queens_iter_count(const QueensIter *it)
+{
+    return it ? it->count : 0;
+}
+
+uint64_t queens_iter_expanded(const QueensIter *it)
+{
+    return it ? it->expanded : 0;
+}
+
+void queens_iter_close(QueensIter *it)
+{
+    if (!it) {
+        return;
+    }
+
+    free(it->board);
+    free(it->levels);
+    free(it);
+}
@@ -0,0 +1,23 @@
+#ifndef QUEENS_ITER_H
+#define QUEENS_ITER_H
+
+#include <stdint.h>
+
+// Ленивый перебор решений задачи о ферзях: по одному решению за вызов,
+// DFS с явным стеком, память O(N) независимо от числа решений.
+typedef struct QueensIter QueensIter;
+
+// N - размерность доски (1..32), Q - число ферзей (1..N); NULL при ошибке
+QueensIter *queens_iter_open(int N, int Q);
+
+// Записывает следующее решение в board[0..N-1] (board[row] = столбец, -1 - пусто).
+// Возвращает 1, если решение найдено, 0 - если перебор завершен.
+int queens_iter_next(QueensIter *it, int *board);
+
+// Сколько решений выдано и сколько состояний раскрыто к текущему моменту
+uint64_t queens_iter_count(const QueensIter *it);
+uint64_t queens_iter_expanded(const QueensIter *it);
+
+void queens_iter_close(QueensIter *it);
+
+#endif
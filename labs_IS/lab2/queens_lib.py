@@ -0,0 +1,137 @@
+import ctypes
+import os
+from typing import List, Optional
+
+
+# =========================
+# Привязка к libqueens.so (ленивый итератор решений из queens_iter.c)
+# =========================
+
+LIB_NAME = "libqueens.so"
+MAX_N = 32
+
+_lib = None
+
+
+def load_library() -> ctypes.CDLL:
+    global _lib
+    if _lib is not None:
+        return _lib
+
+    path = os.path.join(os.path.dirname(os.path.abspath(__file__)), LIB_NAME)
+    try:
+        lib = ctypes.CDLL(path)
+    except OSError:
+        raise RuntimeError(f"Не найдена библиотека {LIB_NAME}: выполните make в каталоге lab2.")
+
+    lib.queens_iter_open.argtypes = [ctypes.c_int, ctypes.c_int]
+    lib.queens_iter_open.restype = ctypes.c_void_p
+    lib.queens_iter_next.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_int)]
+    lib.queens_iter_next.restype = ctypes.c_int
+    lib.queens_iter_count.argtypes = [ctypes.c_void_p]
+    lib.queens_iter_count.restype = ctypes.c_uint64
+    lib.queens_iter_expanded.argtypes = [ctypes.c_void_p]
+    lib.queens_iter_expanded.restype = ctypes.c_uint64
+    lib.queens_iter_close.argtypes = [ctypes.c_void_p]
+    lib.queens_iter_close.restype = None
+
+    lib.queens_complete_check.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+    lib.queens_complete_check.restype = ctypes.c_char_p
+    lib.queens_complete_count.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_int)]
+    lib.queens_complete_count.restype = ctypes.c_uint64
+    lib.queens_complete_first.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_int), ctypes.POINTER(ctypes.c_int)]
+    lib.queens_complete_first.restype = ctypes.c_int
+
+    _lib = lib
+    return lib
+
+
+class QueensIterator:
+    """Выдает решения по одному; в памяти хранится только стек DFS."""
+
+    def __init__(self, n: int, q: int):
+        if n < 1 or n > MAX_N:
+            raise ValueError(f"Размерность доски должна быть в диапазоне 1..{MAX_N}.")
+        if q < 1 or q > n:
+            raise ValueError("Количество ферзей должно быть в диапазоне 1..N.")
+
+        self._lib = load_library()
+        self.n = n
+        self.q = q
+        self._buffer = (ctypes.c_int * n)()
+        self._handle = self._lib.queens_iter_open(n, q)
+        if not self._handle:
+            raise MemoryError("Не удалось создать итератор решений.")
+
+    def next_board(self) -> Optional[List[int]]:
+        if not self._handle:
+            return None
+        if not self._lib.queens_iter_next(self._handle, self._buffer):
+            return None
+        return list(self._buffer)
+
+    @property
+    def count(self) -> int:
+        return self._lib.queens_iter_count(self._handle) if self._handle else 0
+
+    @property
+    def expanded_states(self) -> int:
+        return self._lib.queens_iter_expanded(self._handle) if self._handle else 0
+
+    def close(self):
+        if self._handle:
+            self._lib.queens_iter_close(self._handle)
+            self._handle = None
+
+    def __iter__(self):
+        return self
+
+    def __next__(self) -> List[int]:
+        board = self.next_board()
+        if board is None:
+            raise StopIteration
+        return board
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    def __del__(self):
+        self.close()
+
+
+# =========================
+# Достроение частичной расстановки (queens_complete.c)
+# =========================
+
+def _partial_board(n: int, q: int, board: List[int]):
+    if n < 1 or n > MAX_N:
+        raise ValueError(f"Размерность доски должна быть в диапазоне 1..{MAX_N}.")
+    if q < 1 or q > n:
+        raise ValueError("Количество ферзей должно быть в диапазоне 1..N.")
+    if len(board) != n:
+        raise ValueError("Доска должна содержать N строк (-1 - пустая строка).")
+
+    lib = load_library()
+    buffer = (ctypes.c_int * n)(*board)
+    error = lib.queens_complete_check(n, q, buffer)
+    if error is not None:
+        raise ValueError(error.decode("utf-8"))
+    return lib, buffer
+
+
+def count_completions(n: int, q: int, board: List[int]) -> int:
+    """Число способов достроить доску до Q ферзей в строках 0..Q-1."""
+    lib, buffer = _partial_board(n, q, board)
+    return lib.queens_complete_count(n, q, buffer)
+
+
+def first_completion(n: int, q: int, board: List[int]) -> Optional[List[int]]:
+    """Первое достроение или None, если его нет."""
+    lib, buffer = _partial_board(n, q, board)
+    out = (ctypes.c_int * n)()
+    if lib.queens_complete_first(n, q, buffer, out) != 1:
+        return None
+    return list(out)
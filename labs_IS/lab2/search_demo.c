@@ -0,0 +1,251 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+
+#include "search_engine.h"
+#include "search_problems.h"
+
+// Один и тот же движок поиска на трех задачах: ферзи, восьминашка и явный граф.
+
+#define PUZZLE_DEPTH_LIMIT 31     // самое длинное оптимальное решение восьминашки
+
+typedef enum {
+    PROBLEM_QUEENS,
+    PROBLEM_PUZZLE,
+    PROBLEM_GRAPH
+} ProblemKind;
+
+static const struct {
+    const char *name;
+    EngineAlgorithm algorithm;
+} algorithms[] = {
+    {"bfs", ENGINE_BFS},
+    {"dls", ENGINE_DLS},
+    {"iddfs", ENGINE_IDDFS},
+    {"astar", ENGINE_BEST_FIRST},
+    {"greedy", ENGINE_GREEDY},
+};
+
+#define ALGORITHM_COUNT (int)(sizeof(algorithms) / sizeof(algorithms[0]))
+
+static double nowSeconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static void printUsage(const char *prog)
+{
+    fprintf(stderr, "Использование: %s queens N [Q] АЛГОРИТМ [--first]\n", prog);
+    fprintf(stderr, "       %s puzzle ПОЗИЦИЯ АЛГОРИТМ\n", prog);
+    fprintf(stderr, "       %s graph ФАЙЛ НАЧАЛО ЦЕЛЬ АЛГОРИТМ\n", prog);
+    fprintf(stderr, "  АЛГОРИТМ  bfs | dls[:D] | iddfs[:D] | astar | greedy | all\n");
+    fprintf(stderr, "  ПОЗИЦИЯ   девять цифр по строкам, 0 - пустая клетка (цель 123456780)\n");
+    fprintf(stderr, "  ФАЙЛ      граф в формате лабораторной 1\n");
+    fprintf(stderr, "Ферзи по умолчанию считают все решения, --first - до первого.\n");
+}
+
+static bool parseNumber(const char *text, int *value)
+{
+    char *end;
+    long v = strtol(text, &end, 10);
+
+    if (end == text || *end != '\0' || v < 0 || v > 1000000000L) {
+        return false;
+    }
+
+    *value = (int)v;
+    return true;
+}
+
+// "имя" или "имя:предел"; index = -1 означает all
+static bool parseAlgorithm(const char *text, int *index, int *depthLimit)
+{
+    const char *colon = strchr(text, ':');
+    size_t len = colon ? (size_t)(colon - text) : strlen(text);
+
+    if (colon != NULL && !parseNumber(colon + 1, depthLimit)) {
+        return false;
+    }
+
+    if (len == 3 && strncmp(text, "all", 3) == 0) {
+        *index = -1;
+        return colon == NULL;
+    }
+
+    for (int i = 0; i < ALGORITHM_COUNT; i++) {
+        if (strlen(algorithms[i].name) == len && strncmp(text, algorithms[i].name, len) == 0) {
+            *index = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void printPath(ProblemKind kind, const SearchEngine *engine, int length)
+{
+    const void **states = (const void **)malloc((size_t)length * sizeof(void *));
+    if (!states) {
+        return;
+    }
+    enginePath(engine, states, length);
+
+    if (kind == PROBLEM_GRAPH) {
+        printf("Путь: ");
+        for (int i = 0; i < length; i++) {
+            printf("%s%d", i ? " -> " : "", *(const int *)states[i]);
+        }
+        printf("\n\n");
+    } else if (kind == PROBLEM_PUZZLE) {
+        for (int i = 0; i < length; i++) {
+            const PuzzleState *s = (const PuzzleState *)states[i];
+            printf("Шаг %d:\n", i);
+            for (int r = 0; r < 3; r++) {
+                printf("  %c %c %c\n", s->tiles[r * 3] ? '0' + s->tiles[r * 3] : '.',
+                       s->tiles[r * 3 + 1] ? '0' + s->tiles[r * 3 + 1] : '.',
+                       s->tiles[r * 3 + 2] ? '0' + s->tiles[r * 3 + 2] : '.');
+            }
+        }
+        printf("\n");
+    } else {
+        const QueensState *s = (const QueensState *)states[length - 1];
+        printf("Первое решение:");
+        for (int r = 0; r < s->row; r++) {
+            printf(" %d", s->board[r] + 1);
+        }
+        printf("\n\n");
+    }
+
+    free(states);
+}
+
+static void printEngineStats(const char *name, const EngineStats *st, double seconds)
+{
+    printf("%-7s: целей = %" PRIu64 " | раскрыто = %" PRIu64 " | порождено = %" PRIu64 " | дубликатов = %" PRIu64 " | шагов до первой цели = ",
+           name, st->goals, st->expanded, st->generated, st->duplicates);
+    if (st->stepsToFirstGoal == UINT64_MAX) {
+        printf("-\n");
+    } else {
+        printf("%" PRIu64 " (глубина %d, стоимость %d)\n", st->stepsToFirstGoal, st->goalDepth, st->goalCost);
+    }
+    printf("%-7s  проходов = %d | max Open = %zu | память = %zu КБ | выделений = %d | время = %.3f мс\n",
+           "", st->iterations, st->maxOpen, (st->peakBytes + 1023) / 1024, st->allocations, seconds * 1000.0);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    ProblemKind kind;
+    QueensProblem queens;
+    PuzzleProblem puzzle;
+    GraphProblem graph;
+    SearchProblem problem;
+    const char *algorithmText;
+    int depthLimit;
+    bool allGoals = false;
+
+    memset(&graph, 0, sizeof(graph));
+
+    if (strcmp(argv[1], "queens") == 0) {
+        int N, Q;
+        int next = 3;
+
+        kind = PROBLEM_QUEENS;
+        if (!parseNumber(argv[2], &N) || N < 1 || N > 32) {
+            fprintf(stderr, "Размерность доски должна быть в диапазоне 1..32\n");
+            return 1;
+        }
+        Q = N;
+        if (argc > 4 && parseNumber(argv[3], &Q)) {
+            next = 4;
+        }
+        if (Q < 1 || Q > N || argc <= next) {
+            fprintf(stderr, "Число ферзей должно быть в диапазоне 1..N, затем указывается алгоритм\n");
+            return 1;
+        }
+
+        algorithmText = argv[next];
+        allGoals = !(argc > next + 1 && strcmp(argv[next + 1], "--first") == 0);
+        depthLimit = Q;
+        problem = queensProblem(&queens, N, Q);
+    } else if (strcmp(argv[1], "puzzle") == 0 && argc == 4) {
+        kind = PROBLEM_PUZZLE;
+        if (!puzzleParse(argv[2], &puzzle)) {
+            fprintf(stderr, "Позиция - девять разных цифр 0..8: %s\n", argv[2]);
+            return 1;
+        }
+        if (!puzzleSolvable(&puzzle)) {
+            printf("Позиция %s неразрешима: нечетное число инверсий.\n", argv[2]);
+            return 0;
+        }
+
+        algorithmText = argv[3];
+        depthLimit = PUZZLE_DEPTH_LIMIT;
+        problem = puzzleProblem(&puzzle);
+    } else if (strcmp(argv[1], "graph") == 0 && argc == 6) {
+        int start, goal;
+
+        kind = PROBLEM_GRAPH;
+        if (!graphLoad(argv[2], &graph)) {
+            return 1;
+        }
+        if (!parseNumber(argv[3], &start) || !parseNumber(argv[4], &goal) ||
+            start < 1 || start > graph.vertexCount || goal < 1 || goal > graph.vertexCount) {
+            fprintf(stderr, "Вершины вне диапазона 1..%d\n", graph.vertexCount);
+            graphFree(&graph);
+            return 1;
+        }
+
+        algorithmText = argv[5];
+        depthLimit = graph.vertexCount;
+        problem = graphProblem(&graph, start, goal);
+    } else {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int index;
+    if (!parseAlgorithm(algorithmText, &index, &depthLimit)) {
+        fprintf(stderr, "Неизвестный алгоритм: %s\n", algorithmText);
+        printUsage(argv[0]);
+        graphFree(&graph);
+        return 1;
+    }
+
+    SearchEngine *engine = engineCreate(&problem);
+    int first = index < 0 ? 0 : index;
+    int last = index < 0 ? ALGORITHM_COUNT - 1 : index;
+
+    for (int i = first; i <= last; i++) {
+        SearchOptions options;
+        options.algorithm = algorithms[i].algorithm;
+        options.depthLimit = depthLimit;
+        options.allGoals = allGoals;
+        options.onGoal = NULL;
+        options.goalCtx = NULL;
+
+        double start = nowSeconds();
+        EngineStats stats = engineRun(engine, &options);
+        double seconds = nowSeconds() - start;
+
+        printEngineStats(algorithms[i].name, &stats, seconds);
+        if (index >= 0 && stats.goals > 0) {
+            printf("\n");
+            printPath(kind, engine, enginePath(engine, NULL, 0));
+        }
+    }
+
+    engineFree(engine);
+    graphFree(&graph);
+    return 0;
+}
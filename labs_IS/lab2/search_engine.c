@@ -0,0 +1,582 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "search_engine.h"
+
+#define NODES_PER_CHUNK 4096
+#define SET_INITIAL_CAPACITY 1024
+#define NO_NODE SIZE_MAX
+
+// Заголовок вершины дерева поиска; за ним в том же блоке лежит состояние
+typedef struct {
+    size_t parent;            // NO_NODE у корня
+    int depth;
+    int cost;                 // g: сумма стоимостей шагов от корня
+    int stale;                // состояние позже достигнуто лучшим путем, вершина не раскрывается
+} NodeHeader;
+
+// Ячейка хеш-множества: node == NO_NODE - пусто
+typedef struct {
+    uint64_t hash;
+    size_t node;
+} EngineSlot;
+
+typedef struct {
+    int64_t priority;
+    size_t node;
+} HeapItem;
+
+struct SearchEngine {
+    SearchProblem problem;
+    const SearchOptions *options;
+    bool detectDuplicates;
+    bool stop;
+
+    // Пул вершин: блоки по NODES_PER_CHUNK вершин не перемещаются и переживают проходы IDDFS
+    uint8_t **chunks;
+    size_t chunkCount;
+    size_t chunkCapacity;
+    size_t stride;            // байт на вершину: заголовок и состояние с выравниванием
+    size_t nodeCount;
+
+    EngineSlot *slots;
+    size_t slotCapacity;
+    size_t slotSize;
+
+    size_t *stack;            // Open для DLS
+    size_t stackSize;
+    size_t stackCapacity;
+
+    HeapItem *heap;           // Open для поиска по первому лучшему
+    size_t heapSize;
+    size_t heapCapacity;
+
+    uint8_t *scratch;         // потомки одной вершины до проверки на дубликаты
+    int *costs;
+
+    uint8_t *path;            // копия пути к первой цели
+    int pathLength;
+    int pathCapacity;
+
+    EngineStats stats;
+};
+
+static void *engineAlloc(SearchEngine *e, void *old, size_t bytes)
+{
+    void *ptr = realloc(old, bytes ? bytes : 1);
+    if (!ptr) {
+        fprintf(stderr, "Ошибка выделения памяти для поиска в пространстве состояний.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (e != NULL) {
+        e->stats.allocations++;
+    }
+    return ptr;
+}
+
+// Пул вершин.
+
+static NodeHeader *nodeAt(const SearchEngine *e, size_t idx)
+{
+    return (NodeHeader *)(e->chunks[idx / NODES_PER_CHUNK] + (idx % NODES_PER_CHUNK) * e->stride);
+}
+
+static void *nodeState(const SearchEngine *e, size_t idx)
+{
+    return (uint8_t *)nodeAt(e, idx) + sizeof(NodeHeader);
+}
+
+static size_t newNode(SearchEngine *e, size_t parent, int depth, int cost, const void *state)
+{
+    size_t idx = e->nodeCount;
+    size_t chunk = idx / NODES_PER_CHUNK;
+
+    if (chunk == e->chunkCount) {
+        if (e->chunkCount == e->chunkCapacity) {
+            e->chunkCapacity = e->chunkCapacity ? e->chunkCapacity * 2 : 16;
+            e->chunks = (uint8_t **)engineAlloc(e, e->chunks, e->chunkCapacity * sizeof(uint8_t *));
+        }
+        e->chunks[e->chunkCount++] = (uint8_t *)engineAlloc(e, NULL, NODES_PER_CHUNK * e->stride);
+    }
+
+    NodeHeader *h = nodeAt(e, idx);
+    h->parent = parent;
+    h->depth = depth;
+    h->cost = cost;
+    h->stale = 0;
+    memcpy(h + 1, state, e->problem.stateSize);
+
+    e->nodeCount++;
+    return idx;
+}
+
+// Хеш-множество встреченных состояний (открытая адресация, заполнение не выше 1/2).
+
+static uint64_t stateHash(const SearchEngine *e, const void *state)
+{
+    if (e->problem.hash != NULL) {
+        return e->problem.hash(e->problem.ctx, state);
+    }
+
+    const uint8_t *bytes = (const uint8_t *)state;
+    uint64_t h = 1469598103934665603ULL;
+    for (size_t i = 0; i < e->problem.stateSize; i++) {
+        h = (h ^ bytes[i]) * 1099511628211ULL;
+    }
+    return h ^ (h >> 29);
+}
+
+static void clearSet(SearchEngine *e)
+{
+    for (size_t i = 0; i < e->slotCapacity; i++) {
+        e->slots[i].node = NO_NODE;
+    }
+    e->slotSize = 0;
+}
+
+static EngineSlot *findSlot(const SearchEngine *e, const void *state, uint64_t hash)
+{
+    size_t mask = e->slotCapacity - 1;
+    size_t i = (size_t)hash & mask;
+
+    while (e->slots[i].node != NO_NODE) {
+        if (e->slots[i].hash == hash && memcmp(nodeState(e, e->slots[i].node), state, e->problem.stateSize) == 0) {
+            break;
+        }
+        i = (i + 1) & mask;
+    }
+
+    return &e->slots[i];
+}
+
+static void growSet(SearchEngine *e)
+{
+    EngineSlot *old = e->slots;
+    size_t oldCapacity = e->slotCapacity;
+
+    e->slotCapacity = oldCapacity ? oldCapacity * 2 : SET_INITIAL_CAPACITY;
+    e->slots = (EngineSlot *)engineAlloc(e, NULL, e->slotCapacity * sizeof(EngineSlot));
+    for (size_t i = 0; i < e->slotCapacity; i++) {
+        e->slots[i].node = NO_NODE;
+    }
+
+    size_t mask = e->slotCapacity - 1;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (old[i].node == NO_NODE) {
+            continue;
+        }
+
+        size_t j = (size_t)old[i].hash & mask;
+        while (e->slots[j].node != NO_NODE) {
+            j = (j + 1) & mask;
+        }
+        e->slots[j] = old[i];
+    }
+
+    free(old);
+}
+
+// Open: стек для DLS и двоичная куча для поиска по первому лучшему.
+
+static void pushStack(SearchEngine *e, size_t node)
+{
+    if (e->stackSize == e->stackCapacity) {
+        e->stackCapacity = e->stackCapacity ? e->stackCapacity * 2 : 256;
+        e->stack = (size_t *)engineAlloc(e, e->stack, e->stackCapacity * sizeof(size_t));
+    }
+
+    e->stack[e->stackSize++] = node;
+    if (e->stackSize > e->stats.maxOpen) {
+        e->stats.maxOpen = e->stackSize;
+    }
+}
+
+// При равных приоритетах раньше извлекается вершина, порожденная раньше
+static bool heapLess(const HeapItem *a, const HeapItem *b)
+{
+    return a->priority < b->priority || (a->priority == b->priority && a->node < b->node);
+}
+
+static void pushHeap(SearchEngine *e, int64_t priority, size_t node)
+{
+    if (e->heapSize == e->heapCapacity) {
+        e->heapCapacity = e->heapCapacity ? e->heapCapacity * 2 : 256;
+        e->heap = (HeapItem *)engineAlloc(e, e->heap, e->heapCapacity * sizeof(HeapItem));
+    }
+
+    size_t i = e->heapSize++;
+    HeapItem item = {priority, node};
+
+    while (i > 0 && heapLess(&item, &e->heap[(i - 1) / 2])) {
+        e->heap[i] = e->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    e->heap[i] = item;
+
+    if (e->heapSize > e->stats.maxOpen) {
+        e->stats.maxOpen = e->heapSize;
+    }
+}
+
+static size_t popHeap(SearchEngine *e)
+{
+    size_t top = e->heap[0].node;
+    HeapItem last = e->heap[--e->heapSize];
+    size_t i = 0;
+
+    while (1) {
+        size_t child = 2 * i + 1;
+        if (child >= e->heapSize) {
+            break;
+        }
+        if (child + 1 < e->heapSize && heapLess(&e->heap[child + 1], &e->heap[child])) {
+            child++;
+        }
+        if (!heapLess(&e->heap[child], &last)) {
+            break;
+        }
+        e->heap[i] = e->heap[child];
+        i = child;
+    }
+
+    if (e->heapSize > 0) {
+        e->heap[i] = last;
+    }
+    return top;
+}
+
+// Общие шаги алгоритмов.
+
+static void recordPath(SearchEngine *e, size_t goal)
+{
+    int length = nodeAt(e, goal)->depth + 1;
+
+    if (length > e->pathCapacity) {
+        e->pathCapacity = length;
+        e->path = (uint8_t *)engineAlloc(e, e->path, (size_t)length * e->problem.stateSize);
+    }
+
+    size_t idx = goal;
+    for (int i = length - 1; i >= 0; i--) {
+        memcpy(e->path + (size_t)i * e->problem.stateSize, nodeState(e, idx), e->problem.stateSize);
+        idx = nodeAt(e, idx)->parent;
+    }
+    e->pathLength = length;
+}
+
+static void registerGoal(SearchEngine *e, size_t node)
+{
+    const NodeHeader *h = nodeAt(e, node);
+
+    e->stats.goals++;
+    if (e->stats.stepsToFirstGoal == UINT64_MAX) {
+        e->stats.stepsToFirstGoal = e->stats.expanded;
+        e->stats.goalDepth = h->depth;
+        e->stats.goalCost = h->cost;
+        recordPath(e, node);
+    }
+
+    const SearchOptions *opt = e->options;
+    if (opt->onGoal != NULL && !opt->onGoal(opt->goalCtx, nodeState(e, node), h->depth)) {
+        e->stop = true;
+    }
+    if (!opt->allGoals) {
+        e->stop = true;
+    }
+}
+
+// Новая вершина для состояния или NO_NODE, если оно уже встречено не худшим путем.
+// Повторный путь лучше, если он дешевле (byCost, A*) или мельче (byDepth, DLS):
+// тогда старая вершина помечается устаревшей, и множество ссылается на новую.
+static size_t storeState(SearchEngine *e, size_t parent, int depth, int cost, const void *state, bool byCost, bool byDepth)
+{
+    if (!e->detectDuplicates) {
+        return newNode(e, parent, depth, cost, state);
+    }
+
+    if ((e->slotSize + 1) * 2 > e->slotCapacity) {
+        growSet(e);
+    }
+
+    uint64_t hash = stateHash(e, state);
+    EngineSlot *slot = findSlot(e, state, hash);
+
+    if (slot->node != NO_NODE) {
+        NodeHeader *old = nodeAt(e, slot->node);
+        bool better = (byCost && cost < old->cost) || (byDepth && depth < old->depth);
+
+        if (!better) {
+            e->stats.duplicates++;
+            return NO_NODE;
+        }
+
+        old->stale = 1;
+        slot->node = newNode(e, parent, depth, cost, state);
+        return slot->node;
+    }
+
+    slot->hash = hash;
+    slot->node = newNode(e, parent, depth, cost, state);
+    e->slotSize++;
+    return slot->node;
+}
+
+static size_t acceptChild(SearchEngine *e, size_t parent, int depth, int cost, const void *state, bool byCost, bool byDepth)
+{
+    e->stats.generated++;
+    return storeState(e, parent, depth, cost, state, byCost, byDepth);
+}
+
+static size_t addRoot(SearchEngine *e)
+{
+    // Корень строится в scratch: там достаточно места под состояние
+    e->problem.initialState(e->problem.ctx, e->scratch);
+    return storeState(e, NO_NODE, 0, 0, e->scratch, false, false);
+}
+
+static void resetSearch(SearchEngine *e)
+{
+    e->nodeCount = 0;
+    e->stackSize = 0;
+    e->heapSize = 0;
+    if (e->detectDuplicates) {
+        clearSet(e);
+    }
+}
+
+// Поиск в ширину: Open - вершины пула от head до конца, они добавляются ровно в порядке очереди
+static void runBFS(SearchEngine *e)
+{
+    resetSearch(e);
+    addRoot(e);
+
+    for (size_t head = 0; head < e->nodeCount && !e->stop; head++) {
+        if (e->nodeCount - head > e->stats.maxOpen) {
+            e->stats.maxOpen = e->nodeCount - head;
+        }
+
+        e->stats.expanded++;
+
+        if (e->problem.isGoal(e->problem.ctx, nodeState(e, head))) {
+            registerGoal(e, head);
+            continue;
+        }
+
+        const NodeHeader *h = nodeAt(e, head);
+        int depth = h->depth;
+        int cost = h->cost;
+        int n = e->problem.successors(e->problem.ctx, nodeState(e, head), e->scratch, e->costs);
+
+        for (int k = 0; k < n; k++) {
+            acceptChild(e, head, depth + 1, cost + e->costs[k], e->scratch + (size_t)k * e->problem.stateSize, false, false);
+        }
+    }
+}
+
+// Поиск в глубину до глубины limit; true, если какие-то вершины отсечены пределом.
+// В IDDFS (onlyAtLimit) засчитываются только цели на глубине limit: более мелкие уже
+// найдены предыдущими проходами.
+static bool runDLS(SearchEngine *e, int limit, bool onlyAtLimit)
+{
+    bool cutoff = false;
+
+    resetSearch(e);
+    pushStack(e, addRoot(e));
+
+    while (e->stackSize > 0 && !e->stop) {
+        size_t idx = e->stack[--e->stackSize];
+        NodeHeader *h = nodeAt(e, idx);
+
+        if (h->stale) {
+            continue;
+        }
+
+        // В дереве индексы в стеке возрастают снизу вверх, и вершины пула после idx
+        // не лежат ни в стеке, ни на пути к нему: пул работает как стек
+        if (!e->detectDuplicates) {
+            e->nodeCount = idx + 1;
+        }
+
+        e->stats.expanded++;
+
+        if (e->problem.isGoal(e->problem.ctx, nodeState(e, idx))) {
+            if (!onlyAtLimit || h->depth == limit) {
+                registerGoal(e, idx);
+            }
+            continue;
+        }
+
+        if (h->depth >= limit) {
+            cutoff = true;
+            continue;
+        }
+
+        int depth = h->depth;
+        int cost = h->cost;
+        int n = e->problem.successors(e->problem.ctx, nodeState(e, idx), e->scratch, e->costs);
+
+        // Потомки кладутся в обратном порядке, чтобы первым раскрывался первый потомок
+        for (int k = n - 1; k >= 0; k--) {
+            size_t child = acceptChild(e, idx, depth + 1, cost + e->costs[k], e->scratch + (size_t)k * e->problem.stateSize, false, true);
+            if (child != NO_NODE) {
+                pushStack(e, child);
+            }
+        }
+    }
+
+    return cutoff;
+}
+
+static void runBestFirst(SearchEngine *e, bool greedy)
+{
+    resetSearch(e);
+
+    size_t root = addRoot(e);
+    int h0 = e->problem.heuristic ? e->problem.heuristic(e->problem.ctx, nodeState(e, root)) : 0;
+    pushHeap(e, h0, root);
+
+    while (e->heapSize > 0 && !e->stop) {
+        size_t idx = popHeap(e);
+        const NodeHeader *h = nodeAt(e, idx);
+
+        if (h->stale) {
+            continue;
+        }
+
+        e->stats.expanded++;
+
+        if (e->problem.isGoal(e->problem.ctx, nodeState(e, idx))) {
+            registerGoal(e, idx);
+            continue;
+        }
+
+        int depth = h->depth;
+        int cost = h->cost;
+        int n = e->problem.successors(e->problem.ctx, nodeState(e, idx), e->scratch, e->costs);
+
+        for (int k = 0; k < n; k++) {
+            size_t child = acceptChild(e, idx, depth + 1, cost + e->costs[k], e->scratch + (size_t)k * e->problem.stateSize, !greedy, false);
+            if (child == NO_NODE) {
+                continue;
+            }
+
+            int64_t estimate = e->problem.heuristic ? e->problem.heuristic(e->problem.ctx, nodeState(e, child)) : 0;
+            pushHeap(e, greedy ? estimate : nodeAt(e, child)->cost + estimate, child);
+        }
+    }
+}
+
+// Освобождает пул, множество, Open и путь: каждый engineRun строит их заново, поэтому
+// peakBytes и allocations относятся к одному запуску, а не ко всей жизни движка
+static void releaseStorage(SearchEngine *e)
+{
+    for (size_t i = 0; i < e->chunkCount; i++) {
+        free(e->chunks[i]);
+    }
+    free(e->chunks);
+    free(e->slots);
+    free(e->stack);
+    free(e->heap);
+    free(e->path);
+
+    e->chunks = NULL;
+    e->chunkCount = e->chunkCapacity = e->nodeCount = 0;
+    e->slots = NULL;
+    e->slotCapacity = e->slotSize = 0;
+    e->stack = NULL;
+    e->stackSize = e->stackCapacity = 0;
+    e->heap = NULL;
+    e->heapSize = e->heapCapacity = 0;
+    e->path = NULL;
+    e->pathLength = e->pathCapacity = 0;
+}
+
+SearchEngine *engineCreate(const SearchProblem *problem)
+{
+    SearchEngine *e = (SearchEngine *)calloc(1, sizeof(SearchEngine));
+    if (!e) {
+        fprintf(stderr, "Ошибка выделения памяти для поиска в пространстве состояний.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    e->problem = *problem;
+    e->stride = (sizeof(NodeHeader) + problem->stateSize + 7) & ~(size_t)7;
+
+    int slots = problem->maxSuccessors > 0 ? problem->maxSuccessors : 1;
+    e->scratch = (uint8_t *)engineAlloc(NULL, NULL, (size_t)slots * problem->stateSize);
+    e->costs = (int *)engineAlloc(NULL, NULL, (size_t)slots * sizeof(int));
+    return e;
+}
+
+EngineStats engineRun(SearchEngine *e, const SearchOptions *options)
+{
+    memset(&e->stats, 0, sizeof(e->stats));
+    e->stats.stepsToFirstGoal = UINT64_MAX;
+    e->stats.goalDepth = -1;
+    e->stats.goalCost = -1;
+    e->stats.iterations = 1;
+    e->options = options;
+    e->stop = false;
+    e->detectDuplicates = !e->problem.tree;
+
+    releaseStorage(e);
+    if (e->detectDuplicates) {
+        growSet(e);
+    }
+
+    switch (options->algorithm) {
+    case ENGINE_BFS:
+        runBFS(e);
+        break;
+    case ENGINE_DLS:
+        runDLS(e, options->depthLimit, false);
+        break;
+    case ENGINE_IDDFS:
+        // Предел растет, пока есть отсечения и (для одной цели) цель не найдена
+        e->stats.iterations = 0;
+        for (int limit = 0; limit <= options->depthLimit && !e->stop; limit++) {
+            e->stats.iterations++;
+            if (!runDLS(e, limit, true)) {
+                break;
+            }
+        }
+        break;
+    case ENGINE_BEST_FIRST:
+        runBestFirst(e, false);
+        break;
+    case ENGINE_GREEDY:
+        runBestFirst(e, true);
+        break;
+    }
+
+    // Внутри запуска структуры только растут, поэтому итоговый объем - пиковый
+    e->stats.peakBytes = e->chunkCount * NODES_PER_CHUNK * e->stride + e->slotCapacity * sizeof(EngineSlot) +
+                         e->stackCapacity * sizeof(size_t) + e->heapCapacity * sizeof(HeapItem);
+    return e->stats;
+}
+
+int enginePath(const SearchEngine *e, const void **states, int maxStates)
+{
+    int n = e->pathLength < maxStates ? e->pathLength : maxStates;
+
+    for (int i = 0; i < n; i++) {
+        states[i] = e->path + (size_t)i * e->problem.stateSize;
+    }
+    return e->pathLength;
+}
+
+void engineFree(SearchEngine *e)
+{
+    if (!e) {
+        return;
+    }
+
+    releaseStorage(e);
+    free(e->scratch);
+    free(e->costs);
+    free(e);
+}
@@ -0,0 +1,73 @@
+#ifndef SEARCH_ENGINE_H
+#define SEARCH_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Поиск в пространстве состояний, не зависящий от задачи: задача описывается таблицей функций,
+// состояние - блок фиксированного размера stateSize. Состояния сравниваются побайтно, поэтому
+// неиспользуемые байты состояния (выравнивание, пустой хвост доски) должны быть обнулены.
+
+typedef enum {
+    ENGINE_BFS = 1,           // поиск в ширину
+    ENGINE_DLS = 2,           // поиск в глубину с ограничением глубины
+    ENGINE_IDDFS = 3,         // последовательное углубление: DLS с пределами 0, 1, ..., depthLimit
+    ENGINE_BEST_FIRST = 4,    // A*: приоритет g + h
+    ENGINE_GREEDY = 5         // жадный поиск по первому лучшему: приоритет h
+} EngineAlgorithm;
+
+typedef struct {
+    size_t stateSize;
+    int maxSuccessors;        // сколько потомков может вернуть successors
+    bool tree;                // пространство - дерево: дубликатов не бывает, проверка не нужна
+    void *ctx;
+
+    void (*initialState)(void *ctx, void *state);
+    bool (*isGoal)(void *ctx, const void *state);
+
+    // Потомки подряд в out (по stateSize байт), стоимости шагов в costs; возвращает их число
+    int (*successors)(void *ctx, const void *state, void *out, int *costs);
+
+    // Необязательные: оценка расстояния до цели (NULL - 0) и хеш (NULL - FNV-1a по байтам)
+    int (*heuristic)(void *ctx, const void *state);
+    uint64_t (*hash)(void *ctx, const void *state);
+} SearchProblem;
+
+typedef struct {
+    EngineAlgorithm algorithm;
+    int depthLimit;           // для DLS и IDDFS
+    bool allGoals;            // перебрать все цели, а не остановиться на первой
+
+    // Вызывается для каждой найденной цели; false - остановить поиск. Может быть NULL.
+    bool (*onGoal)(void *ctx, const void *state, int depth);
+    void *goalCtx;
+} SearchOptions;
+
+typedef struct {
+    uint64_t expanded;        // извлечено из Open
+    uint64_t generated;       // порождено потомков
+    uint64_t duplicates;      // потомков, отброшенных как уже встреченные
+    uint64_t goals;
+    uint64_t stepsToFirstGoal;    // номер извлечения первой цели; UINT64_MAX, если цели нет
+    int goalDepth;            // глубина и стоимость первой цели; -1, если цели нет
+    int goalCost;
+    int iterations;           // проходов DLS у IDDFS, у остальных 1
+    size_t maxOpen;           // наибольший размер Open
+    size_t peakBytes;         // память пула, хеш-множества и Open за этот запуск
+    int allocations;          // выделений памяти за этот запуск
+} EngineStats;
+
+typedef struct SearchEngine SearchEngine;
+
+SearchEngine *engineCreate(const SearchProblem *problem);
+
+EngineStats engineRun(SearchEngine *engine, const SearchOptions *options);
+
+// Путь к первой найденной цели: states[0] - начальное состояние. Действителен до следующего
+// engineRun; возвращает число состояний пути (0, если цель не найдена).
+int enginePath(const SearchEngine *engine, const void **states, int maxStates);
+
+void engineFree(SearchEngine *engine);
+
+#endif
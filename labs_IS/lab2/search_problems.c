@@ -0,0 +1,334 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "search_problems.h"
+
+// Ферзи.
+
+static void queensInitial(void *ctx, void *state)
+{
+    (void)ctx;
+    memset(state, 0, sizeof(QueensState));
+}
+
+static bool queensGoal(void *ctx, const void *state)
+{
+    const QueensProblem *q = (const QueensProblem *)ctx;
+    return ((const QueensState *)state)->row == q->Q;
+}
+
+// Столбцы следующей строки слева направо, как в createChildren
+static int queensSuccessors(void *ctx, const void *state, void *out, int *costs)
+{
+    const QueensProblem *q = (const QueensProblem *)ctx;
+    const QueensState *s = (const QueensState *)state;
+    QueensState *children = (QueensState *)out;
+    uint32_t freeCols = ~(s->cols | s->diag | s->anti) & q->mask;
+    int n = 0;
+
+    while (freeCols != 0) {
+        int col = __builtin_ctz(freeCols);
+        uint32_t bit = 1u << col;
+        freeCols &= freeCols - 1;
+
+        QueensState *child = &children[n];
+        memcpy(child, s, sizeof(QueensState));
+        child->board[s->row] = (uint8_t)col;
+        child->row = (uint8_t)(s->row + 1);
+        child->cols = s->cols | bit;
+        child->diag = ((s->diag | bit) << 1) & q->mask;
+        child->anti = (s->anti | bit) >> 1;
+        costs[n++] = 1;
+    }
+
+    return n;
+}
+
+// Оценка - число еще не поставленных ферзей: жадный поиск идет вглубь
+static int queensHeuristic(void *ctx, const void *state)
+{
+    const QueensProblem *q = (const QueensProblem *)ctx;
+    return q->Q - ((const QueensState *)state)->row;
+}
+
+SearchProblem queensProblem(QueensProblem *q, int N, int Q)
+{
+    SearchProblem p;
+
+    q->N = N;
+    q->Q = Q;
+    q->mask = (N >= 32) ? UINT32_MAX : ((1u << N) - 1u);
+
+    memset(&p, 0, sizeof(p));
+    p.stateSize = sizeof(QueensState);
+    p.maxSuccessors = N;
+    p.tree = true;
+    p.ctx = q;
+    p.initialState = queensInitial;
+    p.isGoal = queensGoal;
+    p.successors = queensSuccessors;
+    p.heuristic = queensHeuristic;
+    return p;
+}
+
+// Восьминашка.
+
+static const uint8_t puzzleGoal[9] = {1, 2, 3, 4, 5, 6, 7, 8, 0};
+
+bool puzzleParse(const char *text, PuzzleProblem *p)
+{
+    bool seen[9] = {false};
+
+    if (strlen(text) != 9) {
+        return false;
+    }
+
+    memset(&p->start, 0, sizeof(PuzzleState));
+    for (int i = 0; i < 9; i++) {
+        int tile = text[i] - '0';
+        if (tile < 0 || tile > 8 || seen[tile]) {
+            return false;
+        }
+
+        seen[tile] = true;
+        p->start.tiles[i] = (uint8_t)tile;
+        if (tile == 0) {
+            p->start.blank = (uint8_t)i;
+        }
+    }
+
+    return true;
+}
+
+bool puzzleSolvable(const PuzzleProblem *p)
+{
+    int inversions = 0;
+
+    for (int i = 0; i < 9; i++) {
+        for (int j = i + 1; j < 9; j++) {
+            if (p->start.tiles[i] && p->start.tiles[j] && p->start.tiles[i] > p->start.tiles[j]) {
+                inversions++;
+            }
+        }
+    }
+
+    return inversions % 2 == 0;
+}
+
+static void puzzleInitial(void *ctx, void *state)
+{
+    memcpy(state, &((const PuzzleProblem *)ctx)->start, sizeof(PuzzleState));
+}
+
+static bool puzzleIsGoal(void *ctx, const void *state)
+{
+    (void)ctx;
+    return memcmp(((const PuzzleState *)state)->tiles, puzzleGoal, 9) == 0;
+}
+
+// Ходы пустой клетки: вверх, вниз, влево, вправо
+static int puzzleSuccessors(void *ctx, const void *state, void *out, int *costs)
+{
+    static const int dr[4] = {-1, 1, 0, 0};
+    static const int dc[4] = {0, 0, -1, 1};
+    const PuzzleState *s = (const PuzzleState *)state;
+    PuzzleState *children = (PuzzleState *)out;
+    int row = s->blank / 3;
+    int col = s->blank % 3;
+    int n = 0;
+
+    (void)ctx;
+    for (int k = 0; k < 4; k++) {
+        int r = row + dr[k];
+        int c = col + dc[k];
+        if (r < 0 || r > 2 || c < 0 || c > 2) {
+            continue;
+        }
+
+        PuzzleState *child = &children[n];
+        int to = r * 3 + c;
+        memcpy(child, s, sizeof(PuzzleState));
+        child->tiles[s->blank] = s->tiles[to];
+        child->tiles[to] = 0;
+        child->blank = (uint8_t)to;
+        costs[n++] = 1;
+    }
+
+    return n;
+}
+
+// Сумма манхэттенских расстояний фишек до своих клеток: допустимая оценка для A*
+static int puzzleManhattan(void *ctx, const void *state)
+{
+    const PuzzleState *s = (const PuzzleState *)state;
+    int sum = 0;
+
+    (void)ctx;
+    for (int i = 0; i < 9; i++) {
+        int tile = s->tiles[i];
+        if (tile != 0) {
+            int target = tile - 1;
+            sum += abs(i / 3 - target / 3) + abs(i % 3 - target % 3);
+        }
+    }
+
+    return sum;
+}
+
+SearchProblem puzzleProblem(PuzzleProblem *p)
+{
+    SearchProblem sp;
+
+    memset(&sp, 0, sizeof(sp));
+    sp.stateSize = sizeof(PuzzleState);
+    sp.maxSuccessors = 4;
+    sp.tree = false;
+    sp.ctx = p;
+    sp.initialState = puzzleInitial;
+    sp.isGoal = puzzleIsGoal;
+    sp.successors = puzzleSuccessors;
+    sp.heuristic = puzzleManhattan;
+    return sp;
+}
+
+// Явный граф.
+
+bool graphLoad(const char *filename, GraphProblem *g)
+{
+    FILE *f = fopen(filename, "r");
+    int n;
+
+    memset(g, 0, sizeof(*g));
+    if (f == NULL) {
+        fprintf(stderr, "Не удалось открыть файл %s\n", filename);
+        return false;
+    }
+
+    if (fscanf(f, "%d", &n) != 1 || n <= 0) {
+        fprintf(stderr, "Ошибка чтения числа вершин\n");
+        fclose(f);
+        return false;
+    }
+
+    // Матрица смежности на время чтения: повторные ребра схлопываются, порядок - по возрастанию
+    uint8_t *adj = (uint8_t *)calloc((size_t)(n + 1) * (size_t)(n + 1), 1);
+    if (!adj) {
+        fprintf(stderr, "Ошибка выделения памяти для графа\n");
+        fclose(f);
+        return false;
+    }
+
+    bool ok = true;
+    for (int i = 0; ok && i < n; i++) {
+        int v;
+        if (fscanf(f, "%d", &v) != 1 || v < 1 || v > n) {
+            fprintf(stderr, "Ошибка чтения номера вершины\n");
+            ok = false;
+            break;
+        }
+
+        while (1) {
+            int to;
+            if (fscanf(f, "%d", &to) != 1) {
+                fprintf(stderr, "Ошибка чтения смежной вершины\n");
+                ok = false;
+                break;
+            }
+            if (to == 0) {
+                break;
+            }
+            if (to < 1 || to > n) {
+                fprintf(stderr, "Некорректная смежная вершина: %d\n", to);
+                ok = false;
+                break;
+            }
+            adj[(size_t)v * (size_t)(n + 1) + (size_t)to] = 1;
+        }
+    }
+    fclose(f);
+
+    if (ok) {
+        size_t edges = 0;
+        for (size_t i = 0; i < (size_t)(n + 1) * (size_t)(n + 1); i++) {
+            edges += adj[i];
+        }
+
+        g->vertexCount = n;
+        g->offsets = (int *)malloc((size_t)(n + 2) * sizeof(int));
+        g->targets = (int *)malloc((edges ? edges : 1) * sizeof(int));
+        if (!g->offsets || !g->targets) {
+            fprintf(stderr, "Ошибка выделения памяти для графа\n");
+            graphFree(g);
+            ok = false;
+        } else {
+            int k = 0;
+            for (int v = 0; v <= n; v++) {
+                g->offsets[v] = k;
+                for (int to = 1; v > 0 && to <= n; to++) {
+                    if (adj[(size_t)v * (size_t)(n + 1) + (size_t)to]) {
+                        g->targets[k++] = to;
+                    }
+                }
+            }
+            g->offsets[n + 1] = k;
+        }
+    }
+
+    free(adj);
+    return ok;
+}
+
+void graphFree(GraphProblem *g)
+{
+    free(g->offsets);
+    free(g->targets);
+    g->offsets = NULL;
+    g->targets = NULL;
+    g->vertexCount = 0;
+}
+
+static void graphInitial(void *ctx, void *state)
+{
+    *(int *)state = ((const GraphProblem *)ctx)->start;
+}
+
+static bool graphIsGoal(void *ctx, const void *state)
+{
+    return *(const int *)state == ((const GraphProblem *)ctx)->goal;
+}
+
+static int graphSuccessors(void *ctx, const void *state, void *out, int *costs)
+{
+    const GraphProblem *g = (const GraphProblem *)ctx;
+    int v = *(const int *)state;
+    int *children = (int *)out;
+    int n = 0;
+
+    for (int k = g->offsets[v]; k < g->offsets[v + 1]; k++) {
+        children[n] = g->targets[k];
+        costs[n++] = 1;
+    }
+
+    return n;
+}
+
+SearchProblem graphProblem(GraphProblem *g, int start, int goal)
+{
+    SearchProblem p;
+
+    g->start = start;
+    g->goal = goal;
+
+    memset(&p, 0, sizeof(p));
+    p.stateSize = sizeof(int);
+    p.maxSuccessors = g->vertexCount;
+    p.tree = false;
+    p.ctx = g;
+    p.initialState = graphInitial;
+    p.isGoal = graphIsGoal;
+    p.successors = graphSuccessors;
+    return p;
+}
@@ -0,0 +1,61 @@
+#ifndef SEARCH_PROBLEMS_H
+#define SEARCH_PROBLEMS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "search_engine.h"
+
+// Задачи для search_engine: ферзи, восьминашка и явный граф.
+
+// Ферзи: состояние - первые row строк доски; цель - Q ферзей
+typedef struct {
+    uint32_t cols;
+    uint32_t diag;
+    uint32_t anti;
+    uint8_t row;
+    uint8_t board[32];        // board[r] - столбец ферзя строки r < row, дальше нули
+} QueensState;
+
+typedef struct {
+    int N;
+    int Q;
+    uint32_t mask;
+} QueensProblem;
+
+SearchProblem queensProblem(QueensProblem *q, int N, int Q);
+
+// Восьминашка: tiles[i] - фишка в клетке i (по строкам), 0 - пустая клетка; цель 1..8, 0
+typedef struct {
+    uint8_t tiles[9];
+    uint8_t blank;            // индекс пустой клетки
+} PuzzleState;
+
+typedef struct {
+    PuzzleState start;
+} PuzzleProblem;
+
+// Разбор строки из девяти цифр 0..8 (например "123456780"); false, если строка некорректна
+bool puzzleParse(const char *text, PuzzleProblem *p);
+
+// Позиция разрешима, если число инверсий четно
+bool puzzleSolvable(const PuzzleProblem *p);
+
+SearchProblem puzzleProblem(PuzzleProblem *p);
+
+// Явный граф в формате лабораторной 1: число вершин n, затем для каждой вершины
+// ее номер (1..n) и номера смежных вершин, завершенные нулем
+typedef struct {
+    int vertexCount;
+    int *offsets;             // смежные вершины v - targets[offsets[v]..offsets[v + 1]-1], по возрастанию
+    int *targets;
+    int start;
+    int goal;
+} GraphProblem;
+
+bool graphLoad(const char *filename, GraphProblem *g);
+void graphFree(GraphProblem *g);
+
+SearchProblem graphProblem(GraphProblem *g, int start, int goal);
+
+#endif
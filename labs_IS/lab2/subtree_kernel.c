@@ -0,0 +1,306 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "subtree_kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define KERNEL_X86 0
+#endif
+
+#define LANES 8
+#define FLUSH_STEPS (1 << 24)     // 32-битные счетчики полос сбрасываются раньше, чем могут переполниться
+
+static uint32_t boardMask(int N)
+{
+    return (N >= 32) ? UINT32_MAX : ((1u << N) - 1u);
+}
+
+// Обход одной доски явным стеком. На предпоследней строке потомки не раскрываются:
+// каждый свободный столбец дает решение, поэтому их число равно popcount.
+SubtreeCount kernelCountScalar(const BoardMasks *tasks, size_t count, int depth, int Q, int N)
+{
+    SubtreeCount result = {0, 0};
+    uint32_t mask = boardMask(N);
+    BoardMasks stack[KERNEL_MAX_DEPTH];
+    uint32_t availStack[KERNEL_MAX_DEPTH];
+
+    for (size_t t = 0; t < count; t++) {
+        result.nodes++;
+
+        if (depth == Q) {
+            result.solutions++;
+            continue;
+        }
+
+        BoardMasks cur = tasks[t];
+        uint32_t avail = ~(cur.cols | cur.diag | cur.anti) & mask;
+        int row = depth;
+        int sp = 0;
+
+        while (1) {
+            if (row == Q - 1) {
+                uint32_t leaves = (uint32_t)__builtin_popcount(avail);
+                result.solutions += leaves;
+                result.nodes += leaves;
+                avail = 0;
+            }
+
+            if (avail == 0) {
+                if (sp == 0) {
+                    break;
+                }
+
+                sp--;
+                cur = stack[sp];
+                avail = availStack[sp];
+                row--;
+                continue;
+            }
+
+            uint32_t bit = avail & (0u - avail);
+            avail ^= bit;
+            result.nodes++;
+
+            stack[sp] = cur;
+            availStack[sp] = avail;
+            sp++;
+
+            cur.cols |= bit;
+            cur.diag = ((cur.diag | bit) << 1) & mask;
+            cur.anti = (cur.anti | bit) >> 1;
+            avail = ~(cur.cols | cur.diag | cur.anti) & mask;
+            row++;
+        }
+    }
+
+    return result;
+}
+
+#if KERNEL_X86
+
+// Число единичных битов в каждой 32-битной полосе: таблица по полубайтам через pshufb
+__attribute__((target("avx2")))
+static __m256i popcountLanes(__m256i v)
+{
+    const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+
+    __m256i lo = _mm256_and_si256(v, low);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(table, lo), _mm256_shuffle_epi8(table, hi));
+
+    // Сумма четырех байтов полосы: попарно в 16 бит, затем в 32 бита
+    __m256i words = _mm256_maddubs_epi16(bytes, _mm256_set1_epi8(1));
+    return _mm256_madd_epi16(words, _mm256_set1_epi16(1));
+}
+
+__attribute__((target("avx2")))
+static void flushLanes(__m256i *solutions, __m256i *nodes, SubtreeCount *result)
+{
+    uint32_t s[LANES];
+    uint32_t n[LANES];
+
+    _mm256_storeu_si256((__m256i *)s, *solutions);
+    _mm256_storeu_si256((__m256i *)n, *nodes);
+    for (int l = 0; l < LANES; l++) {
+        result->solutions += s[l];
+        result->nodes += n[l];
+    }
+
+    *solutions = _mm256_setzero_si256();
+    *nodes = _mm256_setzero_si256();
+}
+
+// Восемь досок за шаг: каждая полоса либо ставит ферзя в младший свободный столбец и
+// спускается (сохраняя родителя в своем стеке), либо поднимается на строку вверх, читая
+// родителя сборкой (gather). Полоса, закончившая задачу, сразу получает следующую.
+// Стеки лежат по полосам: ячейка глубины d полосы l имеет индекс l * KERNEL_MAX_DEPTH + d.
+__attribute__((target("avx2")))
+SubtreeCount kernelCountAvx2(const BoardMasks *tasks, size_t count, int depth, int Q, int N)
+{
+    SubtreeCount result = {0, 0};
+
+    if (depth == Q) {
+        result.solutions = count;
+        result.nodes = count;
+        return result;
+    }
+
+    uint32_t stackCols[LANES * KERNEL_MAX_DEPTH];
+    uint32_t stackDiag[LANES * KERNEL_MAX_DEPTH];
+    uint32_t stackAnti[LANES * KERNEL_MAX_DEPTH];
+    uint32_t stackAvail[LANES * KERNEL_MAX_DEPTH];
+
+    // Состояние полос в памяти нужно только при раздаче задач и сохранении родителей
+    uint32_t cols[LANES], diag[LANES], anti[LANES], avail[LANES];
+    int32_t row[LANES];
+    uint32_t mask = boardMask(N);
+    size_t next = 0;
+    int active = 0;
+
+    for (int l = 0; l < LANES; l++) {
+        cols[l] = diag[l] = anti[l] = avail[l] = 0;
+        row[l] = depth;
+        if (next < count) {
+            cols[l] = tasks[next].cols;
+            diag[l] = tasks[next].diag;
+            anti[l] = tasks[next].anti;
+            avail[l] = ~(cols[l] | diag[l] | anti[l]) & mask;
+            result.nodes++;
+            next++;
+            active |= 1 << l;
+        }
+    }
+
+    const __m256i vMask = _mm256_set1_epi32((int)mask);
+    const __m256i vZero = _mm256_setzero_si256();
+    const __m256i vOne = _mm256_set1_epi32(1);
+    const __m256i vLastRow = _mm256_set1_epi32(Q - 1);
+    const __m256i vBaseRow = _mm256_set1_epi32(depth);
+    const __m256i laneBase = _mm256_setr_epi32(0, KERNEL_MAX_DEPTH, 2 * KERNEL_MAX_DEPTH, 3 * KERNEL_MAX_DEPTH,
+                                               4 * KERNEL_MAX_DEPTH, 5 * KERNEL_MAX_DEPTH, 6 * KERNEL_MAX_DEPTH, 7 * KERNEL_MAX_DEPTH);
+
+    __m256i vCols = _mm256_loadu_si256((const __m256i *)cols);
+    __m256i vDiag = _mm256_loadu_si256((const __m256i *)diag);
+    __m256i vAnti = _mm256_loadu_si256((const __m256i *)anti);
+    __m256i vAvail = _mm256_loadu_si256((const __m256i *)avail);
+    __m256i vRow = _mm256_loadu_si256((const __m256i *)row);
+    __m256i vSolutions = vZero;
+    __m256i vNodes = vZero;
+    long steps = 0;
+
+    while (active != 0) {
+        // Предпоследняя строка: все свободные столбцы - решения
+        __m256i lastRow = _mm256_cmpeq_epi32(vRow, vLastRow);
+        __m256i leaves = _mm256_and_si256(popcountLanes(vAvail), lastRow);
+        vSolutions = _mm256_add_epi32(vSolutions, leaves);
+        vNodes = _mm256_add_epi32(vNodes, leaves);
+        vAvail = _mm256_andnot_si256(lastRow, vAvail);
+
+        __m256i empty = _mm256_cmpeq_epi32(vAvail, vZero);
+        int popLanes = _mm256_movemask_ps(_mm256_castsi256_ps(empty)) & active;
+        int pushLanes = ~_mm256_movemask_ps(_mm256_castsi256_ps(empty)) & active;
+
+        // Спуск: родитель с оставшимися столбцами уходит в стек полосы
+        __m256i bit = _mm256_and_si256(vAvail, _mm256_sub_epi32(vZero, vAvail));
+        __m256i rest = _mm256_xor_si256(vAvail, bit);
+
+        if (pushLanes != 0) {
+            _mm256_storeu_si256((__m256i *)cols, vCols);
+            _mm256_storeu_si256((__m256i *)diag, vDiag);
+            _mm256_storeu_si256((__m256i *)anti, vAnti);
+            _mm256_storeu_si256((__m256i *)avail, rest);
+            _mm256_storeu_si256((__m256i *)row, vRow);
+
+            for (int lanes = pushLanes; lanes != 0; lanes &= lanes - 1) {
+                int l = __builtin_ctz((unsigned)lanes);
+                int idx = l * KERNEL_MAX_DEPTH + row[l];
+                stackCols[idx] = cols[l];
+                stackDiag[idx] = diag[l];
+                stackAnti[idx] = anti[l];
+                stackAvail[idx] = avail[l];
+            }
+        }
+
+        __m256i childCols = _mm256_or_si256(vCols, bit);
+        __m256i childDiag = _mm256_and_si256(_mm256_slli_epi32(_mm256_or_si256(vDiag, bit), 1), vMask);
+        __m256i childAnti = _mm256_srli_epi32(_mm256_or_si256(vAnti, bit), 1);
+        __m256i childAvail = _mm256_andnot_si256(_mm256_or_si256(_mm256_or_si256(childCols, childDiag), childAnti), vMask);
+
+        // Подъем: родитель читается из стека полосы, пока строка не опустится ниже корня задачи
+        __m256i parentRow = _mm256_sub_epi32(vRow, vOne);
+        __m256i inTask = _mm256_cmpgt_epi32(parentRow, _mm256_sub_epi32(vBaseRow, vOne));
+        __m256i gatherMask = _mm256_and_si256(empty, inTask);
+        __m256i idx = _mm256_add_epi32(laneBase, parentRow);
+        __m256i parentCols = _mm256_mask_i32gather_epi32(vCols, (const int *)stackCols, idx, gatherMask, 4);
+        __m256i parentDiag = _mm256_mask_i32gather_epi32(vDiag, (const int *)stackDiag, idx, gatherMask, 4);
+        __m256i parentAnti = _mm256_mask_i32gather_epi32(vAnti, (const int *)stackAnti, idx, gatherMask, 4);
+        __m256i parentAvail = _mm256_mask_i32gather_epi32(vAvail, (const int *)stackAvail, idx, gatherMask, 4);
+
+        // empty: полоса поднимается, иначе спускается. Выключенная полоса с нулевыми масками
+        // "поднимается" каждый шаг, но ниже корня сборка маскирована и стек не читается
+        vCols = _mm256_blendv_epi8(childCols, parentCols, empty);
+        vDiag = _mm256_blendv_epi8(childDiag, parentDiag, empty);
+        vAnti = _mm256_blendv_epi8(childAnti, parentAnti, empty);
+        vAvail = _mm256_blendv_epi8(childAvail, parentAvail, empty);
+        vRow = _mm256_blendv_epi8(_mm256_add_epi32(vRow, vOne), parentRow, empty);
+        vNodes = _mm256_sub_epi32(vNodes, _mm256_andnot_si256(empty, _mm256_set1_epi32(-1)));
+
+        // Полосы, поднявшиеся выше корня, получают новую задачу или выключаются
+        int finished = popLanes & ~_mm256_movemask_ps(_mm256_castsi256_ps(inTask));
+        if (finished != 0) {
+            _mm256_storeu_si256((__m256i *)cols, vCols);
+            _mm256_storeu_si256((__m256i *)diag, vDiag);
+            _mm256_storeu_si256((__m256i *)anti, vAnti);
+            _mm256_storeu_si256((__m256i *)avail, vAvail);
+            _mm256_storeu_si256((__m256i *)row, vRow);
+
+            for (int lanes = finished; lanes != 0; lanes &= lanes - 1) {
+                int l = __builtin_ctz((unsigned)lanes);
+                row[l] = depth;
+                if (next < count) {
+                    cols[l] = tasks[next].cols;
+                    diag[l] = tasks[next].diag;
+                    anti[l] = tasks[next].anti;
+                    avail[l] = ~(cols[l] | diag[l] | anti[l]) & mask;
+                    result.nodes++;
+                    next++;
+                } else {
+                    cols[l] = diag[l] = anti[l] = avail[l] = 0;
+                    active &= ~(1 << l);
+                }
+            }
+
+            vCols = _mm256_loadu_si256((const __m256i *)cols);
+            vDiag = _mm256_loadu_si256((const __m256i *)diag);
+            vAnti = _mm256_loadu_si256((const __m256i *)anti);
+            vAvail = _mm256_loadu_si256((const __m256i *)avail);
+            vRow = _mm256_loadu_si256((const __m256i *)row);
+        }
+
+        if (++steps == FLUSH_STEPS) {
+            flushLanes(&vSolutions, &vNodes, &result);
+            steps = 0;
+        }
+    }
+
+    flushLanes(&vSolutions, &vNodes, &result);
+    return result;
+}
+
+int kernelHasAvx2(void)
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+SubtreeCount kernelCountAvx2(const BoardMasks *tasks, size_t count, int depth, int Q, int N)
+{
+    return kernelCountScalar(tasks, count, depth, Q, N);
+}
+
+int kernelHasAvx2(void)
+{
+    return 0;
+}
+
+#endif
+
+SubtreeKernel kernelSelect(const char **name)
+{
+    if (kernelHasAvx2()) {
+        *name = "AVX2, 8 досок";
+        return kernelCountAvx2;
+    }
+
+    *name = "скалярное";
+    return kernelCountScalar;
+}
@@ -0,0 +1,41 @@
+#ifndef SUBTREE_KERNEL_H
+#define SUBTREE_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Подсчет решений в поддеревьях задач-префиксов задачи о ферзях.
+// Скалярное ядро обходит по одной доске явным стеком, AVX2-ядро ведет восемь досок
+// одновременно в 32-битных полосах векторных регистров, у каждой полосы свой стек.
+// Оба ядра считают вершины так же, как рекурсивный countSubtree: корень задачи и каждого потомка.
+
+#define KERNEL_MAX_DEPTH 32
+
+// Маски расстановки первых depth строк
+typedef struct {
+    uint32_t cols;
+    uint32_t diag;
+    uint32_t anti;
+} BoardMasks;
+
+typedef struct {
+    uint64_t solutions;
+    uint64_t nodes;
+} SubtreeCount;
+
+// Все задачи имеют глубину depth; Q - число ферзей, N - размерность доски (до 32)
+typedef SubtreeCount (*SubtreeKernel)(const BoardMasks *tasks, size_t count, int depth, int Q, int N);
+
+SubtreeCount kernelCountScalar(const BoardMasks *tasks, size_t count, int depth, int Q, int N);
+
+// Вне x86 или без поддержки AVX2 в компиляторе вызывает скалярное ядро. Процессор не проверяется:
+// на x86 без AVX2 вызов завершится SIGILL, поэтому ядро берется через kernelSelect
+SubtreeCount kernelCountAvx2(const BoardMasks *tasks, size_t count, int depth, int Q, int N);
+
+// Проверка процессора во время выполнения
+int kernelHasAvx2(void);
+
+// Лучшее доступное ядро; name получает его название
+SubtreeKernel kernelSelect(const char **name);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef BBP_SERIES_H
+#define BBP_SERIES_H
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <omp.h>
+
+// Сумма ряда Бэйли - Борвейна - Плаффа в double: общее ядро PiCalculator::calculate (lab2source.cpp)
+// и PiThread (lab3). pi = sum 16^-k (4/(8k+1) - 2/(8k+4) - 1/(8k+5) - 1/(8k+6)).
+
+// Множитель 16^-k, ниже которого член меньше ulp суммы (~3) и уже не меняет ее
+const double BBP_STOP_FACTOR = DBL_EPSILON / 16;
+
+// Членов между проверками флага остановки и отчетами о прогрессе
+const long long BBP_BLOCK = 1 << 16;
+
+// Прогресс одного потока OpenMP; счетчик занимает отдельную строку кеша, чтобы потоки не мешали друг другу.
+// Выравнивание соблюдается и в std::vector: с C++17 он выделяет память выровненным new.
+// Общий для PiThread (lab3) и замера накладных расходов в lab2source.cpp.
+struct alignas(64) ProgressCounter {
+    std::atomic<long long> done;
+
+    ProgressCounter() : done(0) {}
+};
+
+struct BbpSum {
+    double sum;
+    long long evaluated;      // членов, посчитанных на самом деле
+    bool stopped;             // прервано флагом остановки
+};
+
+inline double bbpTermBody(long long k) {
+    double k8 = 8.0 * (double)k;
+    return 4.0 / (k8 + 1) - 2.0 / (k8 + 4) - 1.0 / (k8 + 5) - 1.0 / (k8 + 6);
+}
+
+// Сумма первых iterations членов. Каждый поток берет непрерывный отрезок [first, last):
+// 16^-first - точное ldexp, дальше множитель делится на 16 без pow. Как только множитель падает
+// ниже BBP_STOP_FACTOR, остаток отрезка пропускается.
+// onBlock(thread, count) получает число пройденных членов отрезка (пропущенные тоже считаются
+// пройденными), shouldStop() проверяется перед каждым блоком. stopFactor = 0 отключает раннее
+// завершение: тогда считаются все члены и onBlock вызывается на каждом блоке (для замера).
+template <class OnBlock, class ShouldStop>
+BbpSum bbpSum(long long iterations, OnBlock onBlock, ShouldStop shouldStop, double stopFactor = BBP_STOP_FACTOR) {
+    double sum = 0.0;
+    long long evaluated = 0;
+    bool stopped = false;
+
+    #pragma omp parallel reduction(+:sum, evaluated) reduction(||:stopped)
+    {
+        int threads = omp_get_num_threads();
+        int id = omp_get_thread_num();
+        long long first = iterations * id / threads;
+        long long last = iterations * (id + 1) / threads;
+
+        // 16^-k < 2^-1074 при k > 268: такие отрезки целиком ниже точности
+        double factor = first < 269 ? std::ldexp(1.0, -4 * (int)first) : 0.0;
+        long long k = first;
+        while (k < last) {
+            if (shouldStop()) {
+                stopped = true;
+                break;
+            }
+
+            long long start = k;
+            long long blockEnd = std::min(last, k + BBP_BLOCK);
+            for (; k < blockEnd && factor >= stopFactor; ++k) {
+                sum += factor * bbpTermBody(k);
+                factor *= 0.0625;
+            }
+            evaluated += k - start;
+
+            if (factor < stopFactor) {
+                onBlock(id, last - start);
+                break;
+            }
+            onBlock(id, k - start);
+        }
+    }
+
+    BbpSum result;
+    result.sum = sum;
+    result.evaluated = evaluated;
+    result.stopped = stopped;
+    return result;
+}
+
+#endif
@@ -0,0 +1,400 @@
+#ifndef BIGNUM_H
+#define BIGNUM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "ntt.h"
+
+// Длинная арифметика для вычисления π: целые со знаком и числа с плавающей точкой.
+// Разряды (limbs) хранятся по основанию 10^9, младшие первыми: десятичные цифры
+// печатаются без перевода между системами счисления.
+
+namespace bignum {
+
+typedef uint32_t Limb;
+typedef std::vector<Limb> Limbs;
+
+const Limb BASE = 1000000000;
+const int BASE_DIGITS = 9;
+
+// Пороги выбора умножения по длине короткого множителя (в разрядах): ниже первого - столбиком,
+// от второго - NTT, между ними - Карацуба. Подобраны по замеру benchmarkMultiply в lab2source.cpp.
+const size_t KARATSUBA_THRESHOLD = 48;
+const size_t NTT_THRESHOLD = 1024;
+
+enum MulAlgorithm {
+    MUL_AUTO,                 // по порогам
+    MUL_SCHOOLBOOK,
+    MUL_KARATSUBA,            // Карацуба до порога столбика, без NTT
+    MUL_NTT                   // NTT при любой длине, пока произведение вмещается в MAX_LENGTH
+};
+
+// Операции над модулями: ноль - пустой вектор, старший разряд ненулевой.
+
+inline void trim(Limbs &a) {
+    while (!a.empty() && a.back() == 0) {
+        a.pop_back();
+    }
+}
+
+inline int compareAbs(const Limbs &a, const Limbs &b) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    for (size_t i = a.size(); i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// a += b * BASE^shift
+inline void addShifted(Limbs &a, const Limbs &b, size_t shift) {
+    if (a.size() < b.size() + shift) {
+        a.resize(b.size() + shift, 0);
+    }
+
+    Limb carry = 0;
+    size_t i = 0;
+    for (; i < b.size(); ++i) {
+        Limb cur = a[i + shift] + b[i] + carry;
+        carry = cur >= BASE;
+        a[i + shift] = carry ? cur - BASE : cur;
+    }
+    for (size_t j = i + shift; carry; ++j) {
+        if (j == a.size()) {
+            a.push_back(0);
+        }
+        Limb cur = a[j] + carry;
+        carry = cur >= BASE;
+        a[j] = carry ? cur - BASE : cur;
+    }
+}
+
+// a -= b, требуется |a| >= |b|
+inline void subInPlace(Limbs &a, const Limbs &b) {
+    Limb borrow = 0;
+    size_t i = 0;
+    for (; i < b.size(); ++i) {
+        Limb sub = b[i] + borrow;
+        borrow = a[i] < sub;
+        a[i] = borrow ? a[i] + BASE - sub : a[i] - sub;
+    }
+    for (; borrow; ++i) {
+        borrow = a[i] == 0;
+        a[i] = borrow ? BASE - 1 : a[i] - 1;
+    }
+    trim(a);
+}
+
+inline Limbs addAbs(const Limbs &a, const Limbs &b) {
+    Limbs r = a;
+    addShifted(r, b, 0);
+    return r;
+}
+
+inline void mulSmallInPlace(Limbs &a, uint32_t m) {
+    uint64_t carry = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t cur = (uint64_t)a[i] * m + carry;
+        a[i] = (Limb)(cur % BASE);
+        carry = cur / BASE;
+    }
+    while (carry) {
+        a.push_back((Limb)(carry % BASE));
+        carry /= BASE;
+    }
+    trim(a);
+}
+
+// out[0..n+m-1] += a * b столбиком; перенос на каждой строке, чтобы сумма не переполнила 64 бита
+inline void mulSchoolbook(const Limb *a, size_t n, const Limb *b, size_t m, Limb *out) {
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t carry = 0;
+        uint64_t ai = a[i];
+        for (size_t j = 0; j < m; ++j) {
+            uint64_t cur = out[i + j] + ai * b[j] + carry;
+            out[i + j] = (Limb)(cur % BASE);
+            carry = cur / BASE;
+        }
+        for (size_t k = i + m; carry; ++k) {
+            uint64_t cur = out[k] + carry;
+            out[k] = (Limb)(cur % BASE);
+            carry = cur / BASE;
+        }
+    }
+}
+
+inline Limbs mulRange(const Limb *a, size_t n, const Limb *b, size_t m, MulAlgorithm algorithm = MUL_AUTO);
+
+inline Limbs mulAbs(const Limbs &a, const Limbs &b, MulAlgorithm algorithm = MUL_AUTO) {
+    return mulRange(a.data(), a.size(), b.data(), b.size(), algorithm);
+}
+
+// Выбор умножения по длинам; Карацуба - три умножения половин вместо четырех
+inline Limbs mulRange(const Limb *a, size_t n, const Limb *b, size_t m, MulAlgorithm algorithm) {
+    if (n < m) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    if (m == 0) {
+        return Limbs();
+    }
+
+    // Явно выбранное NTT, как и столбик, не смотрит на порог Карацубы
+    bool useNtt = algorithm == MUL_NTT || (algorithm == MUL_AUTO && m >= NTT_THRESHOLD);
+    if (useNtt && n + m <= ntt::MAX_LENGTH) {
+        Limbs r = ntt::multiply(a, n, b, m, BASE);
+        trim(r);
+        return r;
+    }
+
+    if (m < KARATSUBA_THRESHOLD || algorithm == MUL_SCHOOLBOOK) {
+        Limbs r(n + m, 0);
+        mulSchoolbook(a, n, b, m, r.data());
+        trim(r);
+        return r;
+    }
+
+    // Сильно разные длины: длинный множитель режется на куски длины короткого
+    if (2 * m <= n) {
+        Limbs r(n + m, 0);
+        for (size_t i = 0; i < n; i += m) {
+            size_t len = std::min(m, n - i);
+            addShifted(r, mulRange(a + i, len, b, m, algorithm), i);
+        }
+        trim(r);
+        return r;
+    }
+
+    size_t k = n / 2;
+    Limbs a0(a, a + k), a1(a + k, a + n);
+    Limbs b0(b, b + k), b1(b + k, b + m);
+    trim(a0);
+    trim(a1);
+    trim(b0);
+    trim(b1);
+
+    Limbs z0 = mulAbs(a0, b0, algorithm);
+    Limbs z2 = mulAbs(a1, b1, algorithm);
+    Limbs z1 = mulAbs(addAbs(a0, a1), addAbs(b0, b1), algorithm);
+    subInPlace(z1, z0);
+    subInPlace(z1, z2);
+
+    Limbs r(n + m, 0);
+    addShifted(r, z0, 0);
+    addShifted(r, z1, k);
+    addShifted(r, z2, 2 * k);
+    trim(r);
+    return r;
+}
+
+class BigInt {
+public:
+    BigInt() : negative(false) {}
+
+    BigInt(int64_t value) : negative(value < 0) {
+        uint64_t v = negative ? 0 - (uint64_t)value : (uint64_t)value;
+        while (v) {
+            mag.push_back((Limb)(v % BASE));
+            v /= BASE;
+        }
+    }
+
+    BigInt(const Limbs &limbs, bool isNegative) : negative(isNegative), mag(limbs) {
+        trim(mag);
+        if (mag.empty()) {
+            negative = false;
+        }
+    }
+
+    bool isZero() const { return mag.empty(); }
+    bool isNegative() const { return negative; }
+    size_t size() const { return mag.size(); }
+    const Limbs &limbs() const { return mag; }
+
+    BigInt operator-() const {
+        BigInt r = *this;
+        r.negative = !negative && !mag.empty();
+        return r;
+    }
+
+    friend BigInt operator+(const BigInt &a, const BigInt &b) {
+        if (a.negative == b.negative) {
+            return BigInt(addAbs(a.mag, b.mag), a.negative);
+        }
+        if (compareAbs(a.mag, b.mag) >= 0) {
+            Limbs r = a.mag;
+            subInPlace(r, b.mag);
+            return BigInt(r, a.negative);
+        }
+        Limbs r = b.mag;
+        subInPlace(r, a.mag);
+        return BigInt(r, b.negative);
+    }
+
+    friend BigInt operator-(const BigInt &a, const BigInt &b) {
+        return a + (-b);
+    }
+
+    friend BigInt operator*(const BigInt &a, const BigInt &b) {
+        return BigInt(mulAbs(a.mag, b.mag), a.negative != b.negative);
+    }
+
+    BigInt &mulSmall(uint32_t m) {
+        mulSmallInPlace(mag, m);
+        if (mag.empty()) {
+            negative = false;
+        }
+        return *this;
+    }
+
+    // Десятичная запись модуля без знака
+    std::string toString() const {
+        if (mag.empty()) {
+            return "0";
+        }
+
+        std::string s = std::to_string(mag.back());
+        s.reserve(mag.size() * BASE_DIGITS);
+        char buf[BASE_DIGITS + 1];
+        for (size_t i = mag.size() - 1; i-- > 0;) {
+            snprintf(buf, sizeof(buf), "%09u", (unsigned)mag[i]);
+            s += buf;
+        }
+        return s;
+    }
+
+private:
+    bool negative;
+    Limbs mag;
+};
+
+// Число с плавающей точкой mant * BASE^exp; точность задается числом разрядов мантиссы
+struct BigFloat {
+    BigInt mant;
+    long exp;
+
+    BigFloat() : exp(0) {}
+    BigFloat(const BigInt &m, long e) : mant(m), exp(e) {}
+};
+
+// Отбрасывание младших разрядов сверх prec
+inline BigFloat truncate(const BigFloat &x, size_t prec) {
+    size_t n = x.mant.size();
+    if (n <= prec) {
+        return x;
+    }
+
+    const Limbs &limbs = x.mant.limbs();
+    Limbs top(limbs.end() - prec, limbs.end());
+    return BigFloat(BigInt(top, x.mant.isNegative()), x.exp + (long)(n - prec));
+}
+
+inline BigFloat mul(const BigFloat &a, const BigFloat &b, size_t prec) {
+    return truncate(BigFloat(a.mant * b.mant, a.exp + b.exp), prec);
+}
+
+// Сдвиг мантиссы на shift разрядов влево: то же число с меньшим показателем
+inline BigInt shiftLimbs(const BigInt &x, size_t shift) {
+    if (x.isZero() || shift == 0) {
+        return x;
+    }
+    Limbs r(shift, 0);
+    r.insert(r.end(), x.limbs().begin(), x.limbs().end());
+    return BigInt(r, x.isNegative());
+}
+
+inline BigFloat add(const BigFloat &a, const BigFloat &b, size_t prec) {
+    long e = std::min(a.exp, b.exp);
+    BigInt sum = shiftLimbs(a.mant, (size_t)(a.exp - e)) + shiftLimbs(b.mant, (size_t)(b.exp - e));
+    return truncate(BigFloat(sum, e), prec);
+}
+
+inline BigFloat sub(const BigFloat &a, const BigFloat &b, size_t prec) {
+    return add(a, BigFloat(-b.mant, b.exp), prec);
+}
+
+// 1 / x с prec разрядами по Ньютону: y += y * (1 - x * y), точность удваивается на каждом шаге
+inline BigFloat reciprocal(const BigInt &x, size_t prec) {
+    const Limbs &limbs = x.limbs();
+    size_t n = limbs.size();
+    double top = limbs[n - 1];
+    long topExp = (long)n - 1;
+    if (n >= 2) {
+        top = top * BASE + limbs[n - 2];
+        topExp--;
+    }
+
+    // Начальное приближение из double: x ~ top * BASE^topExp, мантисса BASE^k / top - два разряда
+    int k = n >= 2 ? 3 : 2;
+    BigFloat y(BigInt((int64_t)(std::pow(1e9, k) / top)), -topExp - k);
+    BigFloat one(BigInt(1), 0);
+    BigFloat xf(x, 0);
+
+    size_t correct = 1;
+    while (true) {
+        correct = std::min(correct * 2, prec);
+        size_t work = correct + 2;
+        BigFloat e = sub(one, mul(truncate(xf, work), y, work), work);
+        y = add(y, mul(y, e, work), work);
+        if (correct == prec) {
+            break;
+        }
+    }
+
+    return truncate(y, prec);
+}
+
+// 1 / sqrt(a) с prec разрядами: y += y * (1 - a * y^2) / 2
+inline BigFloat invSqrt(uint32_t a, size_t prec) {
+    BigFloat y(BigInt((int64_t)(1e18 / std::sqrt((double)a))), -2);
+    BigFloat one(BigInt(1), 0);
+    BigFloat half(BigInt(BASE / 2), -1);
+
+    size_t correct = 1;
+    while (true) {
+        correct = std::min(correct * 2, prec);
+        size_t work = correct + 2;
+        BigFloat t = mul(y, y, work);
+        t.mant.mulSmall(a);
+        BigFloat e = sub(one, t, work);
+        y = add(y, mul(mul(y, e, work), half, work), work);
+        if (correct == prec) {
+            break;
+        }
+    }
+
+    return truncate(y, prec);
+}
+
+// Десятичная запись положительного x с fracDigits знаками после запятой (лишние отбрасываются)
+inline std::string toDecimal(const BigFloat &x, size_t fracDigits) {
+    std::string digits = x.mant.toString();
+    long fracLen = x.exp < 0 ? -x.exp * BASE_DIGITS : 0;
+
+    if (x.exp > 0) {
+        digits.append((size_t)x.exp * BASE_DIGITS, '0');
+    }
+    if ((long)digits.size() <= fracLen) {
+        digits.insert(0, (size_t)(fracLen - (long)digits.size() + 1), '0');
+    }
+
+    std::string intPart = digits.substr(0, digits.size() - (size_t)fracLen);
+    std::string fracPart = digits.substr(digits.size() - (size_t)fracLen);
+    if (fracPart.size() < fracDigits) {
+        fracPart.append(fracDigits - fracPart.size(), '0');
+    }
+
+    return intPart + "." + fracPart.substr(0, fracDigits);
+}
+
+} // namespace bignum
+
+#endif
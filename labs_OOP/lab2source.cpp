@@ -1,42 +1,383 @@
 #include <iostream>
 #include <iomanip>
+#include <string>
 #include <cmath>
+#include <random>
+#include <atomic>
+#include <vector>
+#include <cfloat>
 #include <omp.h>
 
+#include "bbp_series.h"
+#include "bignum.h"
+
 using namespace std;
+using bignum::BigInt;
+using bignum::BigFloat;
+using bignum::Limbs;
+
+// Ряд Чудновского: каждый член добавляет около 14.18 верных десятичных знаков
+const double CHUDNOVSKY_DIGITS_PER_TERM = 14.181647462725477;
+const long SPLIT_TASK_MIN_TERMS = 64;     // более короткие отрезки считаются без новых задач
+
+// Извлечение шестнадцатеричных цифр BBP: одна позиция дает не больше стольких цифр
+const int BBP_HEX_PER_BLOCK = 8;
+const long double BBP_TAIL_EPS = 1e-20L;
 
 class PiCalculator {
 private:
     int iterations;
+    long long effective_iterations;   // членов ряда BBP, посчитанных до схождения
     double pi_value;
+    long digits;
+    string pi_digits;
+
+    // Суммы бинарного разбиения отрезка членов [a, b)
+    struct Split {
+        BigInt P, Q, T;
+    };
+
+    // P(a, b), Q(a, b), T(a, b); P нужна только левым половинам, для корня не считается.
+    // Поддеревья отдаются задачам OpenMP, пока отрезок достаточно длинный.
+    static void binarySplit(long a, long b, bool needP, Split &r) {
+        if (b - a == 1) {
+            if (a == 0) {
+                r.P = BigInt(1);
+                r.Q = BigInt(1);
+                r.T = BigInt(13591409);
+                return;
+            }
+
+            // P = -(6a-5)(2a-1)(6a-1), Q = a^3 * 640320^3 / 24, T = P * (13591409 + 545140134a)
+            r.P = BigInt(-(6 * a - 5));
+            r.P.mulSmall((uint32_t)(2 * a - 1)).mulSmall((uint32_t)(6 * a - 1));
+            r.Q = BigInt(a);
+            r.Q.mulSmall((uint32_t)a).mulSmall((uint32_t)a).mulSmall(640320).mulSmall(640320).mulSmall(26680);
+            r.T = r.P * BigInt(13591409 + 545140134LL * a);
+            return;
+        }
+
+        long m = (a + b) / 2;
+        Split left, right;
+        if (b - a >= SPLIT_TASK_MIN_TERMS) {
+            #pragma omp task shared(left)
+            binarySplit(a, m, true, left);
+            binarySplit(m, b, needP, right);
+            #pragma omp taskwait
+        } else {
+            binarySplit(a, m, true, left);
+            binarySplit(m, b, needP, right);
+        }
+
+        if (needP) {
+            r.P = left.P * right.P;
+        }
+        r.Q = left.Q * right.Q;
+        r.T = left.T * right.Q + left.P * right.T;
+    }
+
+    // 16^e mod m; при m >= 2^32 произведение берется в 128 битах
+    static uint64_t powMod16(uint64_t e, uint64_t m) {
+        uint64_t result = 1 % m;
+        uint64_t base = 16 % m;
+        if (m <= UINT32_MAX) {
+            while (e) {
+                if (e & 1) {
+                    result = result * base % m;
+                }
+                base = base * base % m;
+                e >>= 1;
+            }
+            return result;
+        }
+        while (e) {
+            if (e & 1) {
+                result = (uint64_t)((unsigned __int128)result * base % m);
+            }
+            base = (uint64_t)((unsigned __int128)base * base % m);
+            e >>= 1;
+        }
+        return result;
+    }
+
+    // Дробная часть 16^d * sum 1 / (16^k (8k + j)): левая сумма k <= d по модулю 8k + j,
+    // правая - несколько убывающих членов
+    static long double bbpSeries(int j, long d) {
+        long double s = 0.0L;
+        for (long k = 0; k <= d; ++k) {
+            uint64_t m = 8 * (uint64_t)k + j;
+            s += (long double)powMod16((uint64_t)(d - k), m) / m;
+            s -= floorl(s);
+        }
+
+        long double factor = 1.0L / 16;
+        for (long k = d + 1;; ++k) {
+            long double term = factor / (8 * k + j);
+            if (term < BBP_TAIL_EPS) {
+                break;
+            }
+            s += term;
+            factor /= 16;
+        }
+
+        return s - floorl(s);
+    }
+
+    // Сколько цифр после позиции d верны: левая сумма копит ~d ошибок округления long double,
+    // а комбинация четырех сумм усиливает их до 8 раз. Одна цифра оставлена в запас.
+    // Около 10^7 это 8 цифр, около 10^9 - 6.
+    static int bbpDigitsAt(long d) {
+        long double error = 8.0L * ((long double)d + 1) * LDBL_EPSILON;
+        int digits = (int)floorl(-logl(error) / logl(16.0L)) - 1;
+        return max(1, min(digits, BBP_HEX_PER_BLOCK));
+    }
+
+    // Первые digits шестнадцатеричных цифр после позиции d
+    static void bbpBlock(long d, int digits, char *out) {
+        long double x = 4 * bbpSeries(1, d) - 2 * bbpSeries(4, d) - bbpSeries(5, d) - bbpSeries(6, d);
+        x -= floorl(x);
+        for (int i = 0; i < digits; ++i) {
+            x *= 16;
+            int digit = (int)x;
+            out[i] = "0123456789ABCDEF"[digit];
+            x -= digit;
+        }
+    }
 
 public:
-    PiCalculator(int iter) : iterations(iter), pi_value(0.0) {}
+    PiCalculator(int iter) : iterations(iter), effective_iterations(0), pi_value(0.0), digits(0) {}
+
+    // digitCount знаков после запятой для calculateDigits()
+    PiCalculator(int iter, long digitCount) : iterations(iter), effective_iterations(0), pi_value(0.0), digits(digitCount) {}
 
     void calculate() {
-        double sum = 0.0;
+        BbpSum result = bbpSum(iterations, [](int, long long) {}, [] { return false; });
+
+        pi_value = result.sum;
+        effective_iterations = result.evaluated;
+    }
+
+    // π = 426880 * sqrt(10005) * Q(0, n) / T(0, n) с digits знаками после запятой
+    void calculateDigits() {
+        long terms = (long)(digits / CHUDNOVSKY_DIGITS_PER_TERM) + 2;
+        size_t prec = (size_t)(digits / bignum::BASE_DIGITS) + 3;   // два разряда запаса на ошибки округления
+        Split root;
 
-        #pragma omp parallel for reduction(+:sum)
-        for (int k = 0; k < iterations; ++k) {
-            double term = (1.0 / pow(16, k)) * 
-                          (4.0 / (8 * k + 1) - 2.0 / (8 * k + 4) - 
-                           1.0 / (8 * k + 5) - 1.0 / (8 * k + 6));
-            sum += term;
+        #pragma omp parallel
+        #pragma omp single
+        binarySplit(0, terms, false, root);
+
+        BigInt numerator = root.Q;
+        numerator.mulSmall(426880).mulSmall(10005);
+
+        BigFloat num = bignum::truncate(BigFloat(numerator, 0), prec);
+        BigFloat pi = bignum::mul(bignum::mul(num, bignum::invSqrt(10005, prec), prec),
+                                  bignum::reciprocal(root.T, prec), prec);
+
+        pi_digits = bignum::toDecimal(pi, (size_t)digits);
+        pi_value = stod(pi_digits.substr(0, 18));
+    }
+
+    // count шестнадцатеричных цифр π, начиная с позиции position (1 - первая цифра после точки).
+    // Длина блока зависит от его позиции (bbpDigitsAt); блоки не зависят друг от друга и делятся между потоками.
+    string hexDigits(long position, long count) const {
+        vector<long> starts;
+        long end = position - 1 + count;
+        for (long d = position - 1; d < end; d += bbpDigitsAt(d)) {
+            starts.push_back(d);
         }
 
-        pi_value = sum;
+        string hex((size_t)count + BBP_HEX_PER_BLOCK, '0');
+        long blocks = (long)starts.size();
+
+        #pragma omp parallel for schedule(dynamic)
+        for (long b = 0; b < blocks; ++b) {
+            long d = starts[(size_t)b];
+            bbpBlock(d, bbpDigitsAt(d), &hex[(size_t)(d - (position - 1))]);
+        }
+
+        hex.resize((size_t)count);
+        return hex;
     }
 
     double getPi() const {
         return pi_value;
     }
 
+    long long getEffectiveIterations() const {
+        return effective_iterations;
+    }
+
+    const string &getDigits() const {
+        return pi_digits;
+    }
+
     void printResult() const {
+        if (!pi_digits.empty()) {
+            cout << "value of π: " << pi_digits << endl;
+            return;
+        }
         cout << fixed << setprecision(100) << "value of π: " << pi_value << endl;
+        cout << "effective iterations: " << effective_iterations << " of " << iterations << endl;
     }
 };
 
+// Время одного умножения в мс: повторы, пока замер не займет хотя бы 0.2 с
+static double timeMultiply(const Limbs &a, const Limbs &b, bignum::MulAlgorithm algorithm, Limbs &result) {
+    int repeats = 0;
+    double start = omp_get_wtime();
+    double elapsed;
+    do {
+        result = bignum::mulAbs(a, b, algorithm);
+        ++repeats;
+        elapsed = omp_get_wtime() - start;
+    } while (elapsed < 0.2);
+    return elapsed * 1000.0 / repeats;
+}
+
+// Скорость умножения в зависимости от длины множителей; медленные методы на длинных числах пропускаются
+static void benchmarkMultiply() {
+    const size_t maxSchoolbook = 8192;
+    const size_t maxKaratsuba = 65536;
+    mt19937 rng(12345);
+
+    cout << "threads: " << omp_get_max_threads() << endl;
+    cout << setw(9) << "limbs" << setw(11) << "digits" << setw(14) << "schoolbook,ms" << setw(14) << "karatsuba,ms"
+         << setw(12) << "ntt,ms" << setw(12) << "auto,ms" << setw(16) << "auto,Mdigits/s" << endl;
+
+    for (size_t n = 16; n <= ((size_t)1 << 20); n *= 4) {
+        Limbs a(n), b(n);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = rng() % bignum::BASE;
+            b[i] = rng() % bignum::BASE;
+        }
+        a[n - 1] = b[n - 1] = 1;
+
+        Limbs expected, result;
+        double autoMs = timeMultiply(a, b, bignum::MUL_AUTO, expected);
+        double nttMs = timeMultiply(a, b, bignum::MUL_NTT, result);
+        bool same = result == expected;
+
+        cout << setw(9) << n << setw(11) << n * bignum::BASE_DIGITS << fixed << setprecision(3);
+        if (n <= maxSchoolbook) {
+            cout << setw(14) << timeMultiply(a, b, bignum::MUL_SCHOOLBOOK, result);
+            same = same && result == expected;
+        } else {
+            cout << setw(14) << "-";
+        }
+        if (n <= maxKaratsuba) {
+            cout << setw(14) << timeMultiply(a, b, bignum::MUL_KARATSUBA, result);
+            same = same && result == expected;
+        } else {
+            cout << setw(14) << "-";
+        }
+
+        double digitsPerSecond = 2.0 * n * bignum::BASE_DIGITS / (autoMs / 1000.0);
+        cout << setw(12) << nttMs << setw(12) << autoMs << setw(16) << setprecision(2) << digitsPerSecond / 1e6;
+        cout << (same ? "" : "  results differ!") << endl;
+    }
+}
+
+// Цена отчета о прогрессе, как в PiThread (lab3): bbpSum без раннего завершения (иначе обратные вызовы
+// почти не вызываются) с пустыми обратными вызовами и со счетчиками ProgressCounter и флагом остановки.
+// Берется лучшее время из нескольких повторов.
+static void benchmarkProgress(long long iterations) {
+    const int repeats = 5;
+    vector<ProgressCounter> progress((size_t)omp_get_max_threads());
+    atomic<bool> stop(false);
+    double bare = 0.0, reported = 0.0;
+    bool same = true;
+
+    for (int r = 0; r < repeats; ++r) {
+        double start = omp_get_wtime();
+        BbpSum plain = bbpSum(iterations, [](int, long long) {}, [] { return false; }, 0.0);
+        double bareSeconds = omp_get_wtime() - start;
+
+        start = omp_get_wtime();
+        BbpSum counted = bbpSum(iterations,
+            [&progress](int thread, long long count) {
+                progress[(size_t)thread % progress.size()].done.fetch_add(count, memory_order_relaxed);
+            },
+            [&stop] { return stop.load(memory_order_relaxed); }, 0.0);
+        double reportedSeconds = omp_get_wtime() - start;
+
+        bare = r == 0 ? bareSeconds : min(bare, bareSeconds);
+        reported = r == 0 ? reportedSeconds : min(reported, reportedSeconds);
+        same = same && plain.sum == counted.sum;
+    }
+
+    long long total = 0;
+    for (const ProgressCounter &counter : progress) {
+        total += counter.done.load(memory_order_relaxed);
+    }
+    same = same && total == iterations * repeats;
+
+    cout << "threads: " << omp_get_max_threads() << ", iterations: " << iterations << ", best of " << repeats << endl;
+    cout << fixed << setprecision(3) << "without progress: " << bare << " s" << endl;
+    cout << "with progress:    " << reported << " s" << endl;
+    cout << setprecision(2) << "overhead: " << (reported / bare - 1.0) * 100.0 << " %" << (same ? "" : "  results differ!") << endl;
+}
+
 int main() {
+    int mode;
+    cout << "Choose the method (1 - BBP series in double, 2 - Chudnovsky digits, 3 - multiplication benchmark, "
+            "4 - hex digits from a position, 5 - progress reporting overhead): ";
+    cin >> mode;
+
+    if (mode == 5) {
+        long long iterations;
+        cout << "Enter the count of iterations: ";
+        cin >> iterations;
+        if (!cin || iterations < 1) {
+            cerr << "The count of iterations must be positive" << endl;
+            return 1;
+        }
+
+        benchmarkProgress(iterations);
+        return 0;
+    }
+
+    if (mode == 4) {
+        long position, count;
+        cout << "Enter the position of the first hex digit and the count of digits: ";
+        cin >> position >> count;
+        if (!cin || position < 1 || count < 1) {
+            cerr << "The position and the count must be positive" << endl;
+            return 1;
+        }
+
+        PiCalculator calculator(0);
+        double start = omp_get_wtime();
+        string hex = calculator.hexDigits(position, count);
+        double seconds = omp_get_wtime() - start;
+        cout << "hex digits of π from position " << position << ": " << hex << endl;
+        cout << "time: " << fixed << setprecision(3) << seconds << " s" << endl;
+        return 0;
+    }
+
+    if (mode == 3) {
+        benchmarkMultiply();
+        return 0;
+    }
+
+    if (mode == 2) {
+        long digits;
+        cout << "Enter the count of digits: ";
+        cin >> digits;
+        if (!cin || digits < 1) {
+            cerr << "The count of digits must be positive" << endl;
+            return 1;
+        }
+
+        PiCalculator calculator(0, digits);
+        double start = omp_get_wtime();
+        calculator.calculateDigits();
+        double seconds = omp_get_wtime() - start;
+        calculator.printResult();
+        cout << "time: " << fixed << setprecision(3) << seconds << " s" << endl;
+        return 0;
+    }
+
     int iterations;
     cout << "Enter the count of iterations: ";
     cin >> iterations;
@@ -13,50 +13,54 @@
 #include <atomic>
 #include <iomanip>
 #include <sstream>
-#include <cmath>
+#include <vector>
 #include <omp.h>
 
+#include "bbp_series.h"
+
 // Класс для вычисления числа π в отдельном потоке
 class PiThread : public QThread {
     Q_OBJECT
 public:
     PiThread(int iterations, QObject *parent = nullptr)
-        : QThread(parent), iterations(iterations), completed_iterations(0), stop_flag(false) {}
+        : QThread(parent), stop_flag(false), iterations(iterations), progress(omp_get_max_threads()) {}
 
-    std::atomic<int> completed_iterations; // Количество завершённых итераций
     std::atomic<bool> stop_flag;           // Флаг для остановки вычислений
 
+    // Количество завершённых итераций: сумма счетчиков потоков, читается таймером окна
+    long long completedIterations() const {
+        long long total = 0;
+        for (const ProgressCounter &counter : progress) {
+            total += counter.done.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
 signals:
     void resultReady(const QString &result); 
 
 protected:
     void run() override {
-        double sum = 0.0;
-        int total_iterations = iterations;
-
-        #pragma omp parallel for reduction(+:sum)
-        for (int k = 0; k < total_iterations; ++k) {
-            // Если флаг остановки установлен, пропускаем вычисления
-            if (!stop_flag.load(std::memory_order_relaxed)) {
-                double term = (1.0 / pow(16, k)) *
-                              (4.0 / (8 * k + 1) - 2.0 / (8 * k + 4) -
-                               1.0 / (8 * k + 5) - 1.0 / (8 * k + 6));
-                sum += term;
-            }
-            completed_iterations.fetch_add(1, std::memory_order_relaxed);
-        }
+        // Ядро общее с PiCalculator::calculate: отрезок на поток, остановка после схождения ряда
+        BbpSum result = bbpSum(iterations,
+            [this](int thread, long long count) {
+                progress[(size_t)thread % progress.size()].done.fetch_add(count, std::memory_order_relaxed);
+            },
+            [this] { return stop_flag.load(std::memory_order_relaxed); });
 
         std::ostringstream oss;
-        if (!stop_flag.load()) {
-            oss << std::fixed << std::setprecision(100) << "Значение π: " << sum;
+        if (!result.stopped && !stop_flag.load()) {
+            oss << std::fixed << std::setprecision(100) << "Значение π: " << result.sum
+                << " (посчитано членов ряда: " << result.evaluated << " из " << iterations << ")";
         } else {
-            oss << "Вычисления остановлены на итерации " << completed_iterations.load();
+            oss << "Вычисления остановлены на итерации " << completedIterations();
         }
         emit resultReady(QString::fromStdString(oss.str()));
     }
 
 private:
     int iterations;
+    std::vector<ProgressCounter> progress;     // по счетчику на поток OpenMP, обновляется раз в блок
 };
 
 // Класс основного окна приложения
@@ -185,7 +189,7 @@ private slots:
         timer->setInterval(100);
         connect(timer, &QTimer::timeout, this, [this, iterations]() {
             if (thread && !thread->stop_flag.load()) {
-                int completed = thread->completed_iterations.load(std::memory_order_relaxed);
+                long long completed = thread->completedIterations();
                 int progress = static_cast<int>((completed * 100.0) / iterations);
                 if (progress < 100) {
                     progressBar->setValue(progress);
@@ -1,5 +1,8 @@
 QT += core gui widgets
 TARGET = myproject
+CONFIG += c++17
 SOURCES += main.cpp
 QMAKE_CXXFLAGS += -fopenmp
-LIBS += -fopenmp
\ No newline at end of file
+LIBS += -fopenmp
+INCLUDEPATH += ..
+HEADERS += ../bbp_series.h
@@ -0,0 +1,194 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+
+// Умножение длинных чисел через теоретико-числовое преобразование (NTT) по трем простым
+// модулям и восстановление коэффициентов свертки китайской теоремой об остатках.
+// Произведение трех модулей ~7.9e25 вмещает свертку до 2^22 произведений разрядов < 10^18.
+
+namespace ntt {
+
+// Простые вида c * 2^k + 1 с первообразным корнем 3
+const uint32_t MOD1 = 998244353;      // 119 * 2^23 + 1
+const uint32_t MOD2 = 167772161;      // 5 * 2^25 + 1
+const uint32_t MOD3 = 469762049;      // 7 * 2^26 + 1
+const uint32_t ROOT = 3;
+
+const size_t MAX_LENGTH = (size_t)1 << 23;        // наибольшая длина преобразования для MOD1
+const size_t PARALLEL_MIN_LENGTH = (size_t)1 << 14;   // короче - преобразование в один поток
+const size_t PARALLEL_CHUNK = (size_t)1 << 12;        // бабочек на задачу
+
+template <uint32_t MOD>
+inline uint32_t mulMod(uint32_t a, uint32_t b) {
+    return (uint32_t)((uint64_t)a * b % MOD);
+}
+
+template <uint32_t MOD>
+inline uint32_t powMod(uint32_t b, uint64_t e) {
+    uint32_t r = 1;
+    while (e) {
+        if (e & 1) {
+            r = mulMod<MOD>(r, b);
+        }
+        b = mulMod<MOD>(b, b);
+        e >>= 1;
+    }
+    return r;
+}
+
+// Бабочки блоков [first, last) одного этапа длины len; w[j] - степени корня этапа
+template <uint32_t MOD>
+inline void butterflies(uint32_t *a, size_t len, size_t first, size_t last, const uint32_t *w, size_t jFirst, size_t jLast) {
+    size_t half = len / 2;
+    for (size_t i = first; i < last; i += len) {
+        for (size_t j = jFirst; j < jLast; ++j) {
+            uint32_t u = a[i + j];
+            uint32_t v = mulMod<MOD>(a[i + j + half], w[j]);
+            a[i + j] = u + v >= MOD ? u + v - MOD : u + v;
+            a[i + j + half] = u >= v ? u - v : u + MOD - v;
+        }
+    }
+}
+
+// Итеративное NTT на месте; n - степень двойки. Длинные этапы делятся между задачами OpenMP:
+// при многих блоках - по блокам, при нескольких больших - по бабочкам внутри блока.
+template <uint32_t MOD>
+void transform(std::vector<uint32_t> &a, bool invert) {
+    size_t n = a.size();
+    bool parallel = n >= PARALLEL_MIN_LENGTH && omp_get_level() > 0;
+
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(a[i], a[j]);
+        }
+    }
+
+    std::vector<uint32_t> w(n / 2 + 1);
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        uint32_t step = powMod<MOD>(ROOT, (MOD - 1) / len);
+        if (invert) {
+            step = powMod<MOD>(step, MOD - 2);
+        }
+        w[0] = 1;
+        for (size_t j = 1; j < half; ++j) {
+            w[j] = mulMod<MOD>(w[j - 1], step);
+        }
+
+        uint32_t *data = a.data();
+        const uint32_t *roots = w.data();
+        if (!parallel) {
+            butterflies<MOD>(data, len, 0, n, roots, 0, half);
+        } else if (half <= PARALLEL_CHUNK) {
+            size_t span = std::max(len, PARALLEL_CHUNK * 2);
+            #pragma omp taskloop
+            for (size_t first = 0; first < n; first += span) {
+                butterflies<MOD>(data, len, first, first + span, roots, 0, half);
+            }
+        } else {
+            for (size_t i = 0; i < n; i += len) {
+                #pragma omp taskloop
+                for (size_t j = 0; j < half; j += PARALLEL_CHUNK) {
+                    butterflies<MOD>(data, len, i, i + len, roots, j, j + PARALLEL_CHUNK);
+                }
+            }
+        }
+    }
+
+    if (invert) {
+        uint32_t inv = powMod<MOD>((uint32_t)(n % MOD), MOD - 2);
+        for (size_t i = 0; i < n; ++i) {
+            a[i] = mulMod<MOD>(a[i], inv);
+        }
+    }
+}
+
+// Свертка по модулю MOD; при a == b (возведение в квадрат) второе прямое преобразование не нужно
+template <uint32_t MOD>
+void convolve(const uint32_t *a, size_t n, const uint32_t *b, size_t m, size_t size, std::vector<uint32_t> &out) {
+    out.assign(size, 0);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = a[i] % MOD;
+    }
+    transform<MOD>(out, false);
+
+    if (a == b && n == m) {
+        for (size_t i = 0; i < size; ++i) {
+            out[i] = mulMod<MOD>(out[i], out[i]);
+        }
+    } else {
+        std::vector<uint32_t> fb(size, 0);
+        for (size_t i = 0; i < m; ++i) {
+            fb[i] = b[i] % MOD;
+        }
+        transform<MOD>(fb, false);
+        for (size_t i = 0; i < size; ++i) {
+            out[i] = mulMod<MOD>(out[i], fb[i]);
+        }
+    }
+
+    transform<MOD>(out, true);
+}
+
+// Три свертки - независимые задачи; вне параллельной области она открывается здесь
+inline void convolveAll(const uint32_t *a, size_t n, const uint32_t *b, size_t m, size_t size,
+                        std::vector<uint32_t> &c1, std::vector<uint32_t> &c2, std::vector<uint32_t> &c3) {
+    if (omp_get_level() > 0 || size < PARALLEL_MIN_LENGTH) {
+        #pragma omp task shared(c1) if (size >= PARALLEL_MIN_LENGTH)
+        convolve<MOD1>(a, n, b, m, size, c1);
+        #pragma omp task shared(c2) if (size >= PARALLEL_MIN_LENGTH)
+        convolve<MOD2>(a, n, b, m, size, c2);
+        convolve<MOD3>(a, n, b, m, size, c3);
+        #pragma omp taskwait
+        return;
+    }
+
+    #pragma omp parallel
+    #pragma omp single
+    convolveAll(a, n, b, m, size, c1, c2, c3);
+}
+
+// Произведение чисел в разрядах по основанию base (младшие первыми): n + m разрядов
+inline std::vector<uint32_t> multiply(const uint32_t *a, size_t n, const uint32_t *b, size_t m, uint32_t base) {
+    size_t size = 1;
+    while (size < n + m) {
+        size <<= 1;
+    }
+
+    std::vector<uint32_t> c1, c2, c3;
+    convolveAll(a, n, b, m, size, c1, c2, c3);
+
+    // x = r1 + MOD1 * k2 + MOD1 * MOD2 * k3, затем перенос в основание base
+    const uint32_t inv12 = powMod<MOD2>(MOD1 % MOD2, MOD2 - 2);
+    const uint32_t mod12 = (uint32_t)((uint64_t)MOD1 * MOD2 % MOD3);
+    const uint32_t inv123 = powMod<MOD3>(mod12, MOD3 - 2);
+    const uint64_t mod1x2 = (uint64_t)MOD1 * MOD2;
+
+    std::vector<uint32_t> out(n + m, 0);
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < n + m; ++i) {
+        uint32_t r1 = c1[i];
+        uint32_t k2 = mulMod<MOD2>((c2[i] + MOD2 - r1 % MOD2) % MOD2, inv12);
+        uint64_t x12 = r1 + (uint64_t)MOD1 * k2;
+        uint32_t k3 = mulMod<MOD3>((uint32_t)((c3[i] + MOD3 - x12 % MOD3) % MOD3), inv123);
+
+        unsigned __int128 value = (unsigned __int128)mod1x2 * k3 + x12 + carry;
+        out[i] = (uint32_t)(value % base);
+        carry = value / base;
+    }
+
+    return out;
+}
+
+} // namespace ntt
+
+#endif